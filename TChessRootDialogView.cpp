@@ -306,7 +306,7 @@ void TChessRootDialogView::OnBnClickedResignButton()
 	int decision = AfxMessageBox(_T("Are you sure you want to resign?"), MB_YESNO | MB_ICONQUESTION);
 	if (decision == IDYES) {
 		//submit a resign move
-		tchess::move resignMove = tchess::move(0, 0, tchess::resignMove, 0);
+		tchess::move resignMove = tchess::move(0, 0, tchess::resignMove);
 		gameObject->submitMove(resignMove);
 	}
 }
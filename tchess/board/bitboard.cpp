@@ -0,0 +1,242 @@
+/*
+ * bitboard.cpp
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#include <stdexcept>
+
+#include "bitboard.h"
+
+namespace tchess
+{
+	const bitboard emptyBitboard = 0ULL;
+
+	extern const bitboard fileBitboards[8] = {
+		0x0101010101010101ULL, 0x0202020202020202ULL, 0x0404040404040404ULL, 0x0808080808080808ULL,
+		0x1010101010101010ULL, 0x2020202020202020ULL, 0x4040404040404040ULL, 0x8080808080808080ULL
+	};
+
+	extern const bitboard rankBitboards[8] = {
+		0x00000000000000FFULL, 0x000000000000FF00ULL, 0x0000000000FF0000ULL, 0x00000000FF000000ULL,
+		0x000000FF00000000ULL, 0x0000FF0000000000ULL, 0x00FF000000000000ULL, 0xFF00000000000000ULL
+	};
+
+	extern const bitboard adjacentFileBitboards[8] = {
+		fileBitboards[1],
+		fileBitboards[0] | fileBitboards[2],
+		fileBitboards[1] | fileBitboards[3],
+		fileBitboards[2] | fileBitboards[4],
+		fileBitboards[3] | fileBitboards[5],
+		fileBitboards[4] | fileBitboards[6],
+		fileBitboards[5] | fileBitboards[7],
+		fileBitboards[6]
+	};
+
+	bitboard kingAttacks[64];
+
+	bitboard knightAttacks[64];
+
+	bitboard pawnAttacks[2][64];
+
+	bitboard passedPawnMasks[2][64];
+
+	bitboard betweenBitboards[64][64];
+
+	bitboard lineBitboards[64][64];
+
+	magic_entry bishopMagics[64];
+
+	magic_entry rookMagics[64];
+
+	/*
+	 * Attack sets of all squares and all relevant blocker subsets, the magic entries point into these.
+	 * A bishop has at most 2^9 and a rook at most 2^12 relevant blocker subsets on a square.
+	 */
+	static bitboard bishopAttackTable[5248];
+	static bitboard rookAttackTable[102400];
+
+	/*
+	 * Magic numbers of the squares. These were found with a random search for sparse numbers that
+	 * map every relevant blocker subset of the square without destructive collisions.
+	 */
+	static const bitboard bishopMagicNumbers[64] = {
+		0x0C08081028882700ULL, 0x0208088820424040ULL, 0x2188480100202561ULL, 0x0004104610800140ULL,
+		0x9004504100002000ULL, 0x0A010108C0010041ULL, 0x3800491028200000ULL, 0x0000802101202002ULL,
+		0x81020410B0810100ULL, 0x0408082808404040ULL, 0x0106220084008008ULL, 0x0040182841001082ULL,
+		0x158404504000800EULL, 0x0888810108432808ULL, 0x0100020811180808ULL, 0x0801420A02410400ULL,
+		0x1320559102103101ULL, 0x0182002002240102ULL, 0xA910000200260020ULL, 0x0008010628210000ULL,
+		0x8002000402114461ULL, 0x0000204410080800ULL, 0x0400500205100900ULL, 0x2002014880840100ULL,
+		0x01E1100108102148ULL, 0x0410090044115400ULL, 0x4004084010104040ULL, 0x0202002008008220ULL,
+		0x0001001105004020ULL, 0x0001081022080400ULL, 0x2018842000820806ULL, 0x40008E0000210401ULL,
+		0x2314104102082200ULL, 0x0002100500101109ULL, 0x1224040201411200ULL, 0x0202004040040102ULL,
+		0x0040002022020080ULL, 0x2020004081210080ULL, 0x0442020404004401ULL, 0x0408C08A00090104ULL,
+		0x0898A21821004003ULL, 0xB004189210424820ULL, 0x8008131088031000ULL, 0x0009010148010500ULL,
+		0x2100084104000040ULL, 0x110102108200A100ULL, 0x0010120801144060ULL, 0x0002020A24200200ULL,
+		0x0020880808040000ULL, 0x0A8B041201040103ULL, 0x0140120205114002ULL, 0x6282000242021201ULL,
+		0x080080140D0C0122ULL, 0x0181102011810200ULL, 0x0804041032420400ULL, 0x0020842C00414142ULL,
+		0x06498028010C2082ULL, 0x0062202084042010ULL, 0x8100000211008800ULL, 0x6000000000840400ULL,
+		0x0018000008210100ULL, 0x00040011A0010100ULL, 0x0820090210020204ULL, 0x0402482804858200ULL
+	};
+
+	static const bitboard rookMagicNumbers[64] = {
+		0x0280132180004001ULL, 0x0140001000200040ULL, 0x0880200010000880ULL, 0x2080080005801000ULL,
+		0x0200041020080200ULL, 0x0200041041084200ULL, 0x0400080081124410ULL, 0x2180042100004080ULL,
+		0x8000800099644000ULL, 0x0802003040820100ULL, 0x0105801001862000ULL, 0x0101002008100100ULL,
+		0x1000800400080080ULL, 0x0804800200040080ULL, 0x2001800200800900ULL, 0x00160004088204C1ULL,
+		0x228000C001402000ULL, 0x8510004000200050ULL, 0x3001848020029000ULL, 0x0280808010000801ULL,
+		0x0109010010040800ULL, 0x8000808004000200ULL, 0x8000040081021028ULL, 0x40040A0009004884ULL,
+		0x80C0004280008035ULL, 0x0010004040002000ULL, 0x1101200500410070ULL, 0x8410100080080080ULL,
+		0x000C080080800400ULL, 0x4012008080040002ULL, 0x4000040101000200ULL, 0x0061010200008044ULL,
+		0x0080804010800020ULL, 0x3000201008400040ULL, 0x4112008012002444ULL, 0x0848000880801000ULL,
+		0x00A8008008800400ULL, 0x200200280A00500CULL, 0x080A221024004801ULL, 0xC400008042000104ULL,
+		0x8000400080028022ULL, 0x0220008040018020ULL, 0x4000200011010040ULL, 0x10060040210A0010ULL,
+		0x40820020904A0004ULL, 0x0030040002008080ULL, 0x0200020801840010ULL, 0x0084C04100820004ULL,
+		0x4802010080C2A600ULL, 0x0000400080201880ULL, 0x2040801000200080ULL, 0x0180200842001200ULL,
+		0x0013510008000500ULL, 0x0182000C00808A80ULL, 0x1000524821302400ULL, 0x3800040108488200ULL,
+		0x104A004810210082ULL, 0x0004210010420082ULL, 0xC424110008200241ULL, 0x90101000A0088501ULL,
+		0x0182000420100802ULL, 0x4822001001080402ULL, 0x05D0080090012204ULL, 0x2008140089042846ULL
+	};
+
+	//Rank and file directions of the sliding pieces.
+	static const int bishopDirections[4][2] = { {-1, -1}, {-1, 1}, {1, -1}, {1, 1} };
+	static const int rookDirections[4][2] = { {-1, 0}, {0, -1}, {0, 1}, {1, 0} };
+
+	//Rank and file offsets of the knight jumps.
+	static const int knightJumps[8][2] = { {-2, -1}, {-2, 1}, {-1, -2}, {-1, 2}, {1, -2}, {1, 2}, {2, -1}, {2, 1} };
+
+	//Checks if a rank and file is on the board.
+	static inline bool onBoard(int rank, int file) {
+		return rank >= 0 && rank < 8 && file >= 0 && file < 8;
+	}
+
+	/*
+	 * Slow attack generation by walking the rays square by square, only used to
+	 * fill the tables at startup.
+	 */
+	static bitboard slidingAttacks(unsigned int square, bitboard occupied, const int (&directions)[4][2]) {
+		bitboard attacks = emptyBitboard;
+		for(int i = 0; i < 4; ++i) {
+			int rank = square / 8 + directions[i][0], file = square % 8 + directions[i][1];
+			while(onBoard(rank, file)) {
+				attacks |= squareBitboard(8 * rank + file);
+				if(occupied & squareBitboard(8 * rank + file)) break; //blocked
+				rank += directions[i][0];
+				file += directions[i][1];
+			}
+		}
+		return attacks;
+	}
+
+	/*
+	 * The relevant blockers of a sliding piece: the rays without the last square, since
+	 * a piece on the edge can't block anything.
+	 */
+	static bitboard relevantOccupancy(unsigned int square, const int (&directions)[4][2]) {
+		bitboard mask = emptyBitboard;
+		for(int i = 0; i < 4; ++i) {
+			int rank = square / 8 + directions[i][0], file = square % 8 + directions[i][1];
+			while(onBoard(rank + directions[i][0], file + directions[i][1])) {
+				mask |= squareBitboard(8 * rank + file);
+				rank += directions[i][0];
+				file += directions[i][1];
+			}
+		}
+		return mask;
+	}
+
+	/*
+	 * Sets up the magic entries of a sliding piece and fills its attack table, by enumerating all
+	 * relevant blocker subsets of every square.
+	 */
+	static void initMagics(magic_entry (&magics)[64], const bitboard (&magicNumbers)[64], bitboard* attackTable,
+			const int (&directions)[4][2]) {
+		bitboard* nextAttacks = attackTable;
+		for(unsigned int square = 0; square < 64; ++square) {
+			magic_entry& m = magics[square];
+			m.mask = relevantOccupancy(square, directions);
+			m.magic = magicNumbers[square];
+			m.shift = 64 - popCount(m.mask);
+			m.attacks = nextAttacks;
+			bitboard subset = emptyBitboard; //enumerate all subsets of the mask (carry-rippler)
+			do {
+				bitboard attacks = slidingAttacks(square, subset, directions);
+				bitboard& entry = m.attacks[m.index(subset)];
+				if(entry != emptyBitboard && entry != attacks) {
+					throw std::runtime_error("Invalid magic number for square " + std::to_string(square));
+				}
+				entry = attacks;
+				subset = (subset - m.mask) & m.mask;
+			} while(subset);
+			nextAttacks += 1ULL << popCount(m.mask);
+		}
+	}
+
+	//Fills the tables that are calculated from the square geometry.
+	static bool initBitboardTables() {
+		for(int square = 0; square < 64; ++square) {
+			int rank = square / 8, file = square % 8;
+			//king steps: every square at distance 1
+			bitboard steps = emptyBitboard;
+			for(int dr = -1; dr <= 1; ++dr) {
+				for(int df = -1; df <= 1; ++df) {
+					if((dr != 0 || df != 0) && onBoard(rank + dr, file + df)) {
+						steps |= squareBitboard(8 * (rank + dr) + file + df);
+					}
+				}
+			}
+			kingAttacks[square] = steps;
+			//knight jumps
+			bitboard jumps = emptyBitboard;
+			for(int i = 0; i < 8; ++i) {
+				if(onBoard(rank + knightJumps[i][0], file + knightJumps[i][1])) {
+					jumps |= squareBitboard(8 * (rank + knightJumps[i][0]) + file + knightJumps[i][1]);
+				}
+			}
+			knightAttacks[square] = jumps;
+			//pawn captures: white moves towards rank index 0, black towards rank index 7
+			pawnAttacks[0][square] = pawnAttacks[1][square] = emptyBitboard;
+			for(int df = -1; df <= 1; df += 2) {
+				if(onBoard(rank - 1, file + df)) pawnAttacks[0][square] |= squareBitboard(8 * (rank - 1) + file + df);
+				if(onBoard(rank + 1, file + df)) pawnAttacks[1][square] |= squareBitboard(8 * (rank + 1) + file + df);
+			}
+			//passed pawn masks
+			bitboard files = fileBitboards[file] | adjacentFileBitboards[file];
+			bitboard inFrontWhite = emptyBitboard, inFrontBlack = emptyBitboard;
+			for(int r = 0; r < rank; ++r) inFrontWhite |= rankBitboards[r];
+			for(int r = rank + 1; r < 8; ++r) inFrontBlack |= rankBitboards[r];
+			passedPawnMasks[0][square] = files & inFrontWhite;
+			passedPawnMasks[1][square] = files & inFrontBlack;
+		}
+		initMagics(bishopMagics, bishopMagicNumbers, bishopAttackTable, bishopDirections);
+		initMagics(rookMagics, rookMagicNumbers, rookAttackTable, rookDirections);
+		//lines through two squares, with the empty board attacks of the sliding pieces
+		for(unsigned int from = 0; from < 64; ++from) {
+			for(unsigned int to = 0; to < 64; ++to) {
+				betweenBitboards[from][to] = lineBitboards[from][to] = emptyBitboard;
+				const bitboard ends = squareBitboard(from) | squareBitboard(to);
+				if(from == to) continue;
+				if(rookAttacks(from, emptyBitboard) & squareBitboard(to)) {
+					betweenBitboards[from][to] = rookAttacks(from, squareBitboard(to)) & rookAttacks(to, squareBitboard(from));
+					lineBitboards[from][to] = (rookAttacks(from, emptyBitboard) & rookAttacks(to, emptyBitboard)) | ends;
+				} else if(bishopAttacks(from, emptyBitboard) & squareBitboard(to)) {
+					betweenBitboards[from][to] = bishopAttacks(from, squareBitboard(to)) & bishopAttacks(to, squareBitboard(from));
+					lineBitboards[from][to] = (bishopAttacks(from, emptyBitboard) & bishopAttacks(to, emptyBitboard)) | ends;
+				}
+			}
+		}
+		return true;
+	}
+
+	static const bool bitboardTablesReady = initBitboardTables();
+
+	std::string bitboardToString(bitboard b) {
+		std::string bS;
+		for(unsigned int square = 0; square < 64; ++square) {
+			bS += (b & squareBitboard(square)) ? '1' : '.';
+			if(square % 8 == 7) bS += '\n';
+		}
+		return bS;
+	}
+}
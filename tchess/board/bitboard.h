@@ -0,0 +1,187 @@
+/*
+ * bitboard.h
+ *
+ * Bitboard helpers used by the chessboard next to the mailbox representation.
+ *  - A bitboard is a 64 bit set, bit n is set if square n is in the set.
+ *  - Square numbering is the same as in the mailbox: bit 0 is a8, bit 7 is h8, bit 63 is h1.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_BOARD_BITBOARD_H_
+#define SRC_BOARD_BITBOARD_H_
+
+#include <string>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+namespace tchess
+{
+	//Unsigned 64 bit set, one bit for each square of the board.
+	typedef unsigned long long bitboard;
+
+	//Bitboard with no squares in it.
+	extern const bitboard emptyBitboard;
+
+	//Files of the board, index 0 is the a file.
+	extern const bitboard fileBitboards[8];
+
+	/*
+	 * Ranks of the board, in the order of the mailbox. Index 0 is the 8. rank (black's backrank)
+	 * and index 7 is the 1. rank (white's backrank).
+	 */
+	extern const bitboard rankBitboards[8];
+
+	/*
+	 * For each file the neighbouring files (one to the left, one to the right), without
+	 * the file itself.
+	 */
+	extern const bitboard adjacentFileBitboards[8];
+
+	/*
+	 * The squares that a king can step to from each square. This is also the 8 neighbours
+	 * of a square, which the pawn evaluation uses. Filled at startup.
+	 */
+	extern bitboard kingAttacks[64];
+
+	/*
+	 * The squares that a knight attacks from each square. Filled at startup.
+	 */
+	extern bitboard knightAttacks[64];
+
+	/*
+	 * The squares that a pawn attacks (diagonally forward) from each square. The first index
+	 * is the side of the pawn. Filled at startup.
+	 */
+	extern bitboard pawnAttacks[2][64];
+
+	/*
+	 * Magic bitboard lookup data of one square for a sliding piece. The relevant blockers of the square
+	 * are selected with the mask, then multiplied with the magic number, and the top bits of the result
+	 * are the index of the attack set in the attack table.
+	 *
+	 * Credit to chessprogramming.org for the magic bitboard technique.
+	 */
+	struct magic_entry {
+
+		//Relevant occupancy of the square: the rays of the piece without the edge squares.
+		bitboard mask;
+
+		//Magic number that maps all subsets of the mask to different (or constructively colliding) indices.
+		bitboard magic;
+
+		//Points to the part of the attack table that belongs to this square.
+		bitboard* attacks;
+
+		//64 - the number of index bits.
+		unsigned int shift;
+
+		inline unsigned int index(bitboard occupied) const {
+			return (unsigned int)(((occupied & mask) * magic) >> shift);
+		}
+	};
+
+	//Magic lookup data of the bishop (diagonal) rays. Filled at startup.
+	extern magic_entry bishopMagics[64];
+
+	//Magic lookup data of the rook (file and rank) rays. Filled at startup.
+	extern magic_entry rookMagics[64];
+
+	/*
+	 * The squares that a bishop attacks from a square, with the given occupied squares. The
+	 * first blocker in each direction is included (it may be a capture).
+	 */
+	inline bitboard bishopAttacks(unsigned int square, bitboard occupied) {
+		const magic_entry& m = bishopMagics[square];
+		return m.attacks[m.index(occupied)];
+	}
+
+	/*
+	 * The squares that a rook attacks from a square, with the given occupied squares. The
+	 * first blocker in each direction is included (it may be a capture).
+	 */
+	inline bitboard rookAttacks(unsigned int square, bitboard occupied) {
+		const magic_entry& m = rookMagics[square];
+		return m.attacks[m.index(occupied)];
+	}
+
+	//The squares that a queen attacks from a square, with the given occupied squares.
+	inline bitboard queenAttacks(unsigned int square, bitboard occupied) {
+		return bishopAttacks(square, occupied) | rookAttacks(square, occupied);
+	}
+
+	/*
+	 * The squares strictly between two squares that are on the same rank, file or diagonal, and
+	 * empty for squares that are not. Filled at startup.
+	 */
+	extern bitboard betweenBitboards[64][64];
+
+	/*
+	 * The whole rank, file or diagonal that goes through two squares (both included), and empty
+	 * for squares that are not on a common line. Filled at startup.
+	 */
+	extern bitboard lineBitboards[64][64];
+
+	/*
+	 * The squares that must not contain enemy pawns for a pawn to be passed: the squares in front
+	 * of the pawn on its own and on the adjacent files. First index is the side of the pawn. Filled at startup.
+	 */
+	extern bitboard passedPawnMasks[2][64];
+
+	//Creates a bitboard with only the given square in it.
+	inline bitboard squareBitboard(unsigned int square) {
+		return 1ULL << square;
+	}
+
+	//Counts the squares in a bitboard.
+	inline unsigned int popCount(bitboard b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+		return (unsigned int)__popcnt64(b);
+#elif defined(_MSC_VER)
+		return __popcnt((unsigned int)b) + __popcnt((unsigned int)(b >> 32));
+#else
+		return (unsigned int)__builtin_popcountll(b);
+#endif
+	}
+
+	/*
+	 * Finds the lowest square in the bitboard. The bitboard must not be empty.
+	 */
+	inline unsigned int bitScanForward(bitboard b) {
+#if defined(_MSC_VER) && defined(_M_X64)
+		unsigned long index;
+		_BitScanForward64(&index, b);
+		return index;
+#elif defined(_MSC_VER)
+		unsigned long index;
+		if(_BitScanForward(&index, (unsigned long)b)) {
+			return index;
+		}
+		_BitScanForward(&index, (unsigned long)(b >> 32));
+		return index + 32;
+#else
+		return (unsigned int)__builtin_ctzll(b);
+#endif
+	}
+
+	/*
+	 * Removes the lowest square from the bitboard and returns it. The bitboard
+	 * must not be empty. Used to iterate squares: while(b) { square = popLowestSquare(b); ... }
+	 */
+	inline unsigned int popLowestSquare(bitboard& b) {
+		unsigned int square = bitScanForward(b);
+		b &= b - 1;
+		return square;
+	}
+
+	/*
+	 * Mostly a debug method that creates a string of 8 lines, with 1 for the squares in the
+	 * bitboard and . for the others.
+	 */
+	std::string bitboardToString(bitboard b);
+}
+
+#endif /* SRC_BOARD_BITBOARD_H_ */
@@ -2,9 +2,11 @@
 #include <cstring>
 #include <iostream>
 #include <cstdlib>
+#include <algorithm>
+#include <sstream>
+#include <cctype>
 
 #include "board.h"
-#include "image_utils.h"
 
 /*
  * board.cpp
@@ -118,6 +120,7 @@ namespace tchess
 		std::memcpy(squares, tchess::def_squares, sizeof(squares));
 		kingSquare[white] = defaultKingSquares[white]; //initial king positions
 		kingSquare[black] = defaultKingSquares[black];
+		createBitboards();
 	}
 
 	chessboard::chessboard(const int (&squares)[64]) {
@@ -134,6 +137,33 @@ namespace tchess
 		if(kingSquare[white]==100 || kingSquare[black]==100) {
 			throw std::runtime_error("2 kings not found on this board!");
 		}
+		createBitboards();
+	}
+
+	void chessboard::createBitboards() {
+		std::memset(pieceBitboards, 0, sizeof(pieceBitboards));
+		std::memset(sideBitboards, 0, sizeof(sideBitboards));
+		hashKey = 0;
+		pawnHashKey = 0;
+		phase = 0;
+		for(unsigned int side = white; side <= black; ++side) {
+			midgameScore[side] = 0;
+			endgameScore[side] = 0;
+		}
+		for(unsigned int square = 0; square < 64; ++square) {
+			int piece = squares[square];
+			if(piece != empty) {
+				unsigned int side = piece > 0 ? white : black;
+				unsigned int pieceType = piece > 0 ? piece : -piece;
+				pieceBitboards[side][pieceType] |= squareBitboard(square);
+				sideBitboards[side] |= squareBitboard(square);
+				hashKey ^= zobristPieceKey(piece, square);
+				if(pieceType == pawn) pawnHashKey ^= zobristPieceKey(piece, square);
+				midgameScore[side] += midgamePieceSquareValues[side][pieceType][square];
+				endgameScore[side] += endgamePieceSquareValues[side][pieceType][square];
+				phase += piecePhase[pieceType];
+			}
+		}
 	}
 
 	int chessboard::makeMove(const move& m, unsigned int side) {
@@ -141,38 +171,34 @@ namespace tchess
 		int captured = empty;
 		if(m.isKingsideCastle()) { //kingside castle moves 2 pieces
 			//the move's from and to squares are the kings position before and after the castle
-			squares[from] = empty; //move king
-			squares[to] = OWN_SIDE(side, 5);
+			movePiece(from, to); //move king
 			kingSquare[side] = to; //keep king location updated
-			squares[to + 1] = empty; //move rook
-			squares[from + 1] = OWN_SIDE(side, 4);
+			movePiece(to + 1, from + 1); //move rook
 		} else if(m.isQueensideCastle()) { //queenside castle moves 2 pieces
 			//the moves from and to squares are the kings position before and after the castle
-			squares[from] = empty; //move king
-			squares[to] = OWN_SIDE(side, 5);
+			movePiece(from, to); //move king
 			kingSquare[side] = to; //keep king location updated
-			squares[to - 2] = empty; //move rook
-			squares[from - 1] = OWN_SIDE(side, 4);
+			movePiece(to - 2, from - 1); //move rook
 		} else if(m.isEnPassant()) { //en passant is special, because the captures piece is not on the destination square
-			squares[from] = empty; //move pawn
-			squares[to] = OWN_SIDE(side, 1);
+			movePiece(from, to); //move pawn
 			int capturedAt = side == white ? to+8 : to-8;
-			squares[capturedAt] = empty; //remove pawn
+			removePiece(capturedAt); //remove pawn
 			captured = ENEMY_SIDE(side, 1); //save that the captured piece was an enemy pawn
 		} else if(m.isPromotion()) { //in case of promotion we need to look at what the pawn was promoted to
 			int p = (int)m.promotedTo();
 			int promotedTo = OWN_SIDE(side, p);
 			captured = squares[to]; //if there was a capture, this will save it, if not nothing changes
-			squares[from] = empty;
-			squares[to] = promotedTo; //make the promoted piece
+			if(captured != empty) removePiece(to);
+			removePiece(from);
+			putPiece(to, promotedTo); //make the promoted piece
 		} else { //nothing special about this move
 			captured = squares[to]; //if there was a capture, this will save it, if not nothing changes
 			int pieceThatMoved = squares[from];
 			if(pieceThatMoved == 5 || pieceThatMoved == -5) { //using 5 instead of 'king' const to eliminate warning
 				kingSquare[side] = to; //keep king location updated
 			}
-			squares[from] = empty;
-			squares[to] = pieceThatMoved;
+			if(captured != empty) removePiece(to);
+			movePiece(from, to);
 		}
 		return captured;
 	}
@@ -181,48 +207,38 @@ namespace tchess
 		const unsigned int from = m.getFromSquare(), to = m.getToSquare();
 		if(m.isKingsideCastle()) { //kingside castle moved 2 pieces that need to be unmaked
 			//the move's from and to squares are the kings position before and after the castle
-			squares[to] = empty; //unmake king move
-			squares[from] = OWN_SIDE(side, 5);
+			movePiece(to, from); //unmake king move
 			kingSquare[side] = from; //keep king location updated
-			squares[to + 1] = OWN_SIDE(side, 4); //unmake rook move
-			squares[from + 1] = empty;
+			movePiece(from + 1, to + 1); //unmake rook move
 		} else if(m.isQueensideCastle()) { //queenside castle moves 2 pieces that need to unmaked
 			//the moves from and to squares are the kings position before and after the castle
-			squares[from] = OWN_SIDE(side, 5); //unmove king
-			squares[to] = empty;
+			movePiece(to, from); //unmove king
 			kingSquare[side] = from; //keep king location updated
-			squares[to - 2] = OWN_SIDE(side, 4); //unmove rook
-			squares[from - 1] = empty;
+			movePiece(from - 1, to - 2); //unmove rook
 		} else if(m.isEnPassant()) { //en passant is special, because the captures piece is not on the destination square
-			squares[from] = OWN_SIDE(side, 1); //unmove own pawn
-			squares[to] = empty;
+			movePiece(to, from); //unmove own pawn
 			int capturedAt = side == white ? to+8 : to-8;
-			squares[capturedAt] = ENEMY_SIDE(side, 1); //replace enemy pawn
+			putPiece(capturedAt, ENEMY_SIDE(side, 1)); //replace enemy pawn
 		} else if(m.isPromotion()) { //in case of promotion a pawn must be placed to the departure square instead of the promotion piece
-			squares[from] = OWN_SIDE(side, 1); //replace pawn
-			squares[to] = capturedPiece; // replace the captured piece (sets to empty in case of no capture)
+			removePiece(to); //remove promoted piece
+			putPiece(from, OWN_SIDE(side, 1)); //replace pawn
+			if(capturedPiece != empty) putPiece(to, capturedPiece); // replace the captured piece
 		} else  { //normal move
 			int pieceThatMoved = squares[to]; //we can find the piece that moved on the destination square
-			squares[from] = pieceThatMoved; //place to its original square
 			if(pieceThatMoved == 5 || pieceThatMoved == -5) { //using 5 instead of 'king' const to eliminate warning
 				kingSquare[side] = from; //keep king location updated
 			}
-			squares[to] = capturedPiece; // replace the captured piece (sets to empty in case of no capture)
+			movePiece(to, from); //place to its original square
+			if(capturedPiece != empty) putPiece(to, capturedPiece); // replace the captured piece
 		}
 	}
 
 	bool chessboard::isInsufficientMaterial() const {
 		//count all pieces
-		int pieceCounts[2][7] = {
-				{0, 0, 0, 0, 0, 0, 0},
-				{0, 0, 0, 0, 0, 0, 0}
-		};
-		for(int square = 0; square < 64; ++square) {
-			int piece = squares[square];
-			if(piece != empty) {
-				int side = piece > 0 ? white : black;
-				piece = piece > 0 ? piece : -piece;
-				pieceCounts[side][piece]++;
+		unsigned int pieceCounts[2][7];
+		for(unsigned int side = 0; side < 2; ++side) {
+			for(unsigned int piece = pawn; piece <= queen; ++piece) {
+				pieceCounts[side][piece] = popCount(pieceBitboards[side][piece]);
 			}
 		}
 		//it can only be insufficient material if both sides does not have: pawn, rook, queen
@@ -278,41 +294,91 @@ namespace tchess
 		enPassantCaptureSquares[white] = noEnPassant;
 		enPassantCaptureSquares[black] = noEnPassant;
 		sideToMove = white; //white begins
+		halfmoveClock = 0;
+		fullmoveNumber = 1;
+		//all castling rights, no en passant and white to move
+		hashKey = Random64[castleKeyOffset] ^ Random64[castleKeyOffset + 1] ^ Random64[castleKeyOffset + 2] ^ Random64[castleKeyOffset + 3];
 	}
 
 	void game_information::disableKingsideCastleRight(unsigned int side) {
+		if(kingsideCastleRight[side]) { //only changes the hash if the right was not yet lost
+			hashKey ^= Random64[castleKeyOffset + 2 * side];
+		}
 		kingsideCastleRight[side] = false;
 	}
 
 	void game_information::disableQueensideCastleRight(unsigned int side) {
+		if(queensideCastleRight[side]) {
+			hashKey ^= Random64[castleKeyOffset + 2 * side + 1];
+		}
 		queensideCastleRight[side] = false;
 	}
 
 	void game_information::setEnPassantSquare(unsigned int side, unsigned int square) {
+		//remove the file of the old square from the hash, add the new one
+		if(enPassantCaptureSquares[side] != noEnPassant) {
+			hashKey ^= Random64[enPassantKeyOffset + enPassantCaptureSquares[side] % 8];
+		}
+		if((int)square != noEnPassant) {
+			hashKey ^= Random64[enPassantKeyOffset + square % 8];
+		}
 		enPassantCaptureSquares[side] = square;
 	}
 
+	void game_information::restore(unsigned int side, unsigned int castleRights, int enPassantSquare, uint64 key, unsigned int clock) {
+		sideToMove = side;
+		kingsideCastleRight[white] = (castleRights & 1) != 0;
+		queensideCastleRight[white] = (castleRights & 2) != 0;
+		kingsideCastleRight[black] = (castleRights & 4) != 0;
+		queensideCastleRight[black] = (castleRights & 8) != 0;
+		enPassantCaptureSquares[side] = enPassantSquare;
+		enPassantCaptureSquares[1-side] = noEnPassant;
+		hashKey = key;
+		halfmoveClock = clock;
+	}
+
 	//update method
 
-	static unsigned int defaultRookSquares[2][2] = { //queenside first, then kingside
-			{56, 63}, // <-- white rook squares
-			{0, 7} // <-- black rook squares
-	};
+	//Removes the castle rights that are lost when a piece moves from or to the square.
+	static inline void updateCastleRights(unsigned int square, game_information& info) {
+		switch(square) {
+		case 60: //white king
+			info.disableKingsideCastleRight(white);
+			info.disableQueensideCastleRight(white);
+			break;
+		case 63: //white kingside rook
+			info.disableKingsideCastleRight(white);
+			break;
+		case 56: //white queenside rook
+			info.disableQueensideCastleRight(white);
+			break;
+		case 4: //black king
+			info.disableKingsideCastleRight(black);
+			info.disableQueensideCastleRight(black);
+			break;
+		case 7: //black kingside rook
+			info.disableKingsideCastleRight(black);
+			break;
+		case 0: //black queenside rook
+			info.disableQueensideCastleRight(black);
+			break;
+		}
+	}
 
 	void updateGameInformation(const chessboard& board, const move& m, game_information& info) {
 		int sideThatMoved = info.getSideToMove(); //not updated yet
 		int enemySide = 1-sideThatMoved;
-		//handle castle rights
-		int onKingsSquare = board[defaultKingSquares[sideThatMoved]];
-		int onQRookSquare = board[defaultRookSquares[sideThatMoved][0]];
-		int onKRookSquare = board[defaultRookSquares[sideThatMoved][1]];
-		if(onKingsSquare != 5 && onKingsSquare != -5) { //if the king is not on his def square anymore, both catle rights are lost
-			info.disableKingsideCastleRight(sideThatMoved);
-			info.disableQueensideCastleRight(sideThatMoved);
-		} else if(onQRookSquare != 4 && onQRookSquare != -4) { //if the queenside rook is not at it's place, then disable queenside castle right
-			info.disableQueensideCastleRight(sideThatMoved);
-		} else if(onKRookSquare != 4 && onKRookSquare != -4) {  //if the kingside rook is not at it's place, then disable kingside castle right
-			info.disableKingsideCastleRight(sideThatMoved);
+		//handle castle rights, a captured rook loses the right too
+		updateCastleRights(m.getFromSquare(), info);
+		updateCastleRights(m.getToSquare(), info);
+		//captures and pawn moves reset the fifty move counter
+		if(m.isCapture() || m.isPromotion() || board[m.getToSquare()] == pawn || board[m.getToSquare()] == -(int)pawn) {
+			info.setHalfmoveClock(0);
+		} else {
+			info.setHalfmoveClock(info.getHalfmoveClock() + 1);
+		}
+		if(sideThatMoved == black) { //a full move is complete
+			info.setFullmoveNumber(info.getFullmoveNumber() + 1);
 		}
 		if(m.isKingsideCastle() || m.isQueensideCastle()) {
 			info.setHasCastled(sideThatMoved);
@@ -352,9 +418,120 @@ namespace tchess
 		return number;
 	}
 
+	//FEN import and export
+
+	void loadFen(const std::string& fen, chessboard& board, game_information& info) {
+		std::istringstream fields(fen);
+		std::string pieces, sideToMove, castling, enPassant;
+		if(!(fields >> pieces >> sideToMove >> castling >> enPassant)) {
+			throw std::runtime_error("Invalid FEN, missing fields: " + fen);
+		}
+		//piece placement, from the 8. rank to the 1., which is the same order as the mailbox
+		int squares[64] = {};
+		unsigned int square = 0, kingCount[2] = { 0, 0 };
+		for(char c: pieces) {
+			if(c == '/') {
+				if(square % 8 != 0 || square == 0 || square == 64) throw std::runtime_error("Invalid FEN, wrong rank length: " + fen);
+				continue;
+			}
+			if(c >= '1' && c <= '8') {
+				if(square % 8 + (c - '0') > 8) throw std::runtime_error("Invalid FEN, wrong rank length: " + fen);
+				square += c - '0';
+				continue;
+			}
+			if(square >= 64) throw std::runtime_error("Invalid FEN, too many squares: " + fen);
+			int piece = empty;
+			for(int code = (int)pawn; code <= (int)queen; ++code) {
+				if(pieceNameFromCode(code) == std::toupper(c)) piece = code;
+			}
+			if(piece == empty) throw std::runtime_error(std::string("Invalid FEN, unknown piece: ") + c);
+			if(piece == (int)king) ++kingCount[std::isupper(c) ? white : black];
+			squares[square++] = std::isupper(c) ? piece : -piece;
+		}
+		if(square != 64) throw std::runtime_error("Invalid FEN, not 64 squares: " + fen);
+		if(kingCount[white] != 1 || kingCount[black] != 1) throw std::runtime_error("Invalid FEN, each side must have one king: " + fen);
+		board = chessboard(squares);
+		info = game_information();
+		//side to move
+		if(sideToMove != "w" && sideToMove != "b") throw std::runtime_error("Invalid FEN, side to move: " + sideToMove);
+		unsigned int side = sideToMove == "w" ? white : black;
+		info.setSideToMove(side);
+		//castling rights, the right is dropped if the king or the rook is not on its home square anymore
+		if(castling != "-" && castling.find_first_not_of("KQkq") != std::string::npos) {
+			throw std::runtime_error("Invalid FEN, castling rights: " + castling);
+		}
+		for(unsigned int s = white; s <= black; ++s) {
+			const int sign = s == white ? 1 : -1;
+			const unsigned int kingHome = s == white ? 60 : 4;
+			const bool kingAtHome = board[kingHome] == sign * (int)king;
+			if(!kingAtHome || castling.find(s == white ? 'K' : 'k') == std::string::npos || board[kingHome + 3] != sign * (int)rook) {
+				info.disableKingsideCastleRight(s);
+			}
+			if(!kingAtHome || castling.find(s == white ? 'Q' : 'q') == std::string::npos || board[kingHome - 4] != sign * (int)rook) {
+				info.disableQueensideCastleRight(s);
+			}
+		}
+		//en passant target square, it must be behind a pawn of the other side that could have just double pushed
+		if(enPassant != "-") {
+			const char expectedRank = side == white ? '6' : '3';
+			if(enPassant.size() != 2 || enPassant[0] < 'a' || enPassant[0] > 'h' || enPassant[1] != expectedRank) {
+				throw std::runtime_error("Invalid FEN, en passant square: " + enPassant);
+			}
+			info.setEnPassantSquare(side, createSquareNumber(enPassant));
+		}
+		//move counters, optional
+		unsigned int halfmoveClock = 0, fullmoveNumber = 1;
+		std::string counter;
+		if(fields >> counter) {
+			if(counter.find_first_not_of("0123456789") != std::string::npos) throw std::runtime_error("Invalid FEN, halfmove clock: " + counter);
+			halfmoveClock = (unsigned int)std::stoul(counter);
+		}
+		if(fields >> counter) {
+			if(counter.find_first_not_of("0123456789") != std::string::npos || std::stoul(counter) == 0) {
+				throw std::runtime_error("Invalid FEN, fullmove number: " + counter);
+			}
+			fullmoveNumber = (unsigned int)std::stoul(counter);
+		}
+		info.setHalfmoveClock(halfmoveClock);
+		info.setFullmoveNumber(fullmoveNumber);
+	}
+
+	std::string createFen(const chessboard& board, const game_information& info) {
+		std::string fen;
+		for(unsigned int rank = 0; rank < 8; ++rank) {
+			unsigned int emptyCount = 0;
+			for(unsigned int file = 0; file < 8; ++file) {
+				int piece = board[8 * rank + file];
+				if(piece == empty) {
+					++emptyCount;
+					continue;
+				}
+				if(emptyCount > 0) fen += (char)('0' + emptyCount);
+				emptyCount = 0;
+				char name = pieceNameFromCode(std::abs(piece));
+				fen += piece > 0 ? name : (char)std::tolower(name);
+			}
+			if(emptyCount > 0) fen += (char)('0' + emptyCount);
+			if(rank < 7) fen += '/';
+		}
+		const unsigned int side = info.getSideToMove();
+		fen += side == white ? " w " : " b ";
+		std::string castling;
+		if(info.getKingsideCastleRights(white)) castling += 'K';
+		if(info.getQueensideCastleRights(white)) castling += 'Q';
+		if(info.getKingsideCastleRights(black)) castling += 'k';
+		if(info.getQueensideCastleRights(black)) castling += 'q';
+		fen += castling.empty() ? "-" : castling;
+		fen += ' ';
+		const int enPassantSquare = (int)info.getEnPassantSquare(side);
+		fen += enPassantSquare == noEnPassant ? "-" : createSquareName(enPassantSquare);
+		fen += ' ' + std::to_string(info.getHalfmoveClock()) + ' ' + std::to_string(info.getFullmoveNumber());
+		return fen;
+	}
+
 	//move generation implementation
 
-	void move_generator::generatePseudoLegalPawnMoves(unsigned int side, unsigned int square, std::vector<move>& moves) const {
+	void move_generator::generatePseudoLegalPawnMoves(unsigned int side, unsigned int square, move_list& moves) const {
 		int inFront, captureLeft, captureRight;
 		bool hasCaptureLeftSquare = false, hasCaptureRightSquare = false;
 		if(side == white) { //pawn moves for white
@@ -371,58 +548,58 @@ namespace tchess
 				int inFrontFar = board[square-16]; //this square is in front of the square in front of the white pawn
 				//double pawn push is only possible of 2 squares in front of the pawn are empty
 				if(inFront == empty && inFrontFar == empty) {
-					moves.push_back(move(square, square-16, doublePawnPush, 0)); //register possible double pawn push
+					moves.push_back(move(square, square-16, doublePawnPush), 0); //register possible double pawn push
 					//adding the en passant capture square is not done here
 				}
 				if(inFront == empty) { //the pawn can still choose to only move one square
-					moves.push_back(move(square, square-8, quietMove, 0));
+					moves.push_back(move(square, square-8, quietMove), 0);
 				}
 				//despite the double push, the pawn can still choose to capture
 				if(hasCaptureLeftSquare && captureLeft < 0) { //enemy piece on the left capture square
 					int captured = std::abs(captureLeft);
-					moves.push_back(move(square, square-9, capture, mvvLvaArray[pawn][captured]));
+					moves.push_back(move(square, square-9, capture), mvvLvaArray[pawn][captured]);
 				}
 				if(hasCaptureRightSquare && captureRight < 0) { //enemy piece on the right capture square
 					int captured = std::abs(captureRight);
-					moves.push_back(move(square, square-7, capture, mvvLvaArray[pawn][captured]));
+					moves.push_back(move(square, square-7, capture), mvvLvaArray[pawn][captured]);
 				}
 			} else if(square / 8 == 1) { //the pawn is ready to promote if it can move/capture forward
 				if(inFront == empty) { //the pawn can quietly move into the promotion rank if there is nothing in front
-					moves.push_back(move(square, square-8, knightPromotion, promotionScoreArray[knightPromotion]));
-					moves.push_back(move(square, square-8, bishopPromotion, promotionScoreArray[bishopPromotion]));
-					moves.push_back(move(square, square-8, rookPromotion, promotionScoreArray[rookPromotion]));
-					moves.push_back(move(square, square-8, queenPromotion, promotionScoreArray[queenPromotion]));
+					moves.push_back(move(square, square-8, knightPromotion), promotionScoreArray[knightPromotion]);
+					moves.push_back(move(square, square-8, bishopPromotion), promotionScoreArray[bishopPromotion]);
+					moves.push_back(move(square, square-8, rookPromotion), promotionScoreArray[rookPromotion]);
+					moves.push_back(move(square, square-8, queenPromotion), promotionScoreArray[queenPromotion]);
 				}
 				if(hasCaptureLeftSquare && captureLeft < 0) { //enemy piece on the left (promotion) capture square
 					int captured = std::abs(captureLeft);
-					moves.push_back(move(square, square-9, knightPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[knightPromotion]));
-					moves.push_back(move(square, square-9, bishopPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[bishopPromotion]));
-					moves.push_back(move(square, square-9, rookPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[rookPromotion]));
-					moves.push_back(move(square, square-9, queenPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[queenPromotion]));
+					moves.push_back(move(square, square-9, knightPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[knightPromotion]);
+					moves.push_back(move(square, square-9, bishopPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[bishopPromotion]);
+					moves.push_back(move(square, square-9, rookPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[rookPromotion]);
+					moves.push_back(move(square, square-9, queenPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[queenPromotion]);
 				}
 				if(hasCaptureRightSquare && captureRight < 0) { //enemy piece on the right (promotion) capture square
 					int captured = std::abs(captureRight);
-					moves.push_back(move(square, square-7, knightPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[knightPromotion]));
-					moves.push_back(move(square, square-7, bishopPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[bishopPromotion]));
-					moves.push_back(move(square, square-7, rookPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[rookPromotion]));
-					moves.push_back(move(square, square-7, queenPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[queenPromotion]));
+					moves.push_back(move(square, square-7, knightPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[knightPromotion]);
+					moves.push_back(move(square, square-7, bishopPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[bishopPromotion]);
+					moves.push_back(move(square, square-7, rookPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[rookPromotion]);
+					moves.push_back(move(square, square-7, queenPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[queenPromotion]);
 				}
 			} else { //the pawn can neither double push nor promote
 				if(inFront == empty) { //the pawn can advance if the way is empty
-					moves.push_back(move(square, square-8, quietMove, 0));
+					moves.push_back(move(square, square-8, quietMove), 0);
 				}
 				//the pawn can also capture
 				if(hasCaptureLeftSquare && captureLeft < 0) { //enemy piece on the left capture square
 					int captured = std::abs(captureLeft);
-					moves.push_back(move(square, square-9, capture, mvvLvaArray[pawn][captured]));
+					moves.push_back(move(square, square-9, capture), mvvLvaArray[pawn][captured]);
 				} else if(hasCaptureLeftSquare && (square-9) == gameInfo.getEnPassantSquare(white)) { //en passant capture possible to the left
-					moves.push_back(move(square, square-9, enPassantCapture, mvvLvaArray[pawn][pawn]));
+					moves.push_back(move(square, square-9, enPassantCapture), mvvLvaArray[pawn][pawn]);
 				}
 				if(hasCaptureRightSquare && captureRight < 0) { //enemy piece on the right capture square
 					int captured = std::abs(captureRight);
-					moves.push_back(move(square, square-7, capture, mvvLvaArray[pawn][captured]));
+					moves.push_back(move(square, square-7, capture), mvvLvaArray[pawn][captured]);
 				} else if(hasCaptureRightSquare && (square-7) == gameInfo.getEnPassantSquare(white)) { //en passant capture possible to the right
-					moves.push_back(move(square, square-7, enPassantCapture, mvvLvaArray[pawn][pawn]));
+					moves.push_back(move(square, square-7, enPassantCapture), mvvLvaArray[pawn][pawn]);
 				}
 			}
 		} else { //pawn moves for black
@@ -439,322 +616,476 @@ namespace tchess
 				int inFrontFar = board[square+16]; //this square is in front of the square in front of the black pawn
 				//double pawn push is only possible of 2 squares in front of the pawn are empty
 				if(inFront == empty && inFrontFar == empty) {
-					moves.push_back(move(square, square+16, doublePawnPush, 0)); //register possible double pawn push
+					moves.push_back(move(square, square+16, doublePawnPush), 0); //register possible double pawn push
 					//adding the en passant capture square is not done here
 				}
 				if(inFront == empty) { //the pawn can still choose to only move one square
-					moves.push_back(move(square, square+8, quietMove, 0));
+					moves.push_back(move(square, square+8, quietMove), 0);
 				}
 				//despite the double push, the pawn can still choose to capture
 				if(hasCaptureLeftSquare && captureLeft > 0) { //enemy piece on the left capture square
 					int captured = std::abs(captureLeft);
-					moves.push_back(move(square, square+7, capture, mvvLvaArray[pawn][captured]));
+					moves.push_back(move(square, square+7, capture), mvvLvaArray[pawn][captured]);
 				}
 				if(hasCaptureRightSquare && captureRight > 0) { //enemy piece on the right capture square
 					int captured = std::abs(captureRight);
-					moves.push_back(move(square, square+9, capture, mvvLvaArray[pawn][captured]));
+					moves.push_back(move(square, square+9, capture), mvvLvaArray[pawn][captured]);
 				}
 			} else if(square / 8 == 6) { //the pawn is ready to promote if it can move/capture forward
 				if(inFront == empty) { //the pawn can quietly move into the promotion rank if there is nothing in front
-					moves.push_back(move(square, square+8, knightPromotion, promotionScoreArray[knightPromotion]));
-					moves.push_back(move(square, square+8, bishopPromotion, promotionScoreArray[bishopPromotion]));
-					moves.push_back(move(square, square+8, rookPromotion, promotionScoreArray[rookPromotion]));
-					moves.push_back(move(square, square+8, queenPromotion, promotionScoreArray[queenPromotion]));
+					moves.push_back(move(square, square+8, knightPromotion), promotionScoreArray[knightPromotion]);
+					moves.push_back(move(square, square+8, bishopPromotion), promotionScoreArray[bishopPromotion]);
+					moves.push_back(move(square, square+8, rookPromotion), promotionScoreArray[rookPromotion]);
+					moves.push_back(move(square, square+8, queenPromotion), promotionScoreArray[queenPromotion]);
 				}
 				if(hasCaptureLeftSquare && captureLeft > 0) { //enemy piece on the left (promotion) capture square
 					int captured = std::abs(captureLeft);
-					moves.push_back(move(square, square+7, knightPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[knightPromotion]));
-					moves.push_back(move(square, square+7, bishopPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[bishopPromotion]));
-					moves.push_back(move(square, square+7, rookPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[rookPromotion]));
-					moves.push_back(move(square, square+7, queenPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[queenPromotion]));
+					moves.push_back(move(square, square+7, knightPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[knightPromotion]);
+					moves.push_back(move(square, square+7, bishopPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[bishopPromotion]);
+					moves.push_back(move(square, square+7, rookPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[rookPromotion]);
+					moves.push_back(move(square, square+7, queenPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[queenPromotion]);
 				}
 				if(hasCaptureRightSquare && captureRight > 0) { //enemy piece on the right (promotion) capture square
 					int captured = std::abs(captureRight);
-					moves.push_back(move(square, square+9, knightPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[knightPromotion]));
-					moves.push_back(move(square, square+9, bishopPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[bishopPromotion]));
-					moves.push_back(move(square, square+9, rookPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[rookPromotion]));
-					moves.push_back(move(square, square+9, queenPromotionCap, mvvLvaArray[pawn][captured]+promotionScoreArray[queenPromotion]));
+					moves.push_back(move(square, square+9, knightPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[knightPromotion]);
+					moves.push_back(move(square, square+9, bishopPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[bishopPromotion]);
+					moves.push_back(move(square, square+9, rookPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[rookPromotion]);
+					moves.push_back(move(square, square+9, queenPromotionCap), mvvLvaArray[pawn][captured]+promotionScoreArray[queenPromotion]);
 				}
 			} else { //the pawn can neither double push nor promote
 				if(inFront == empty) { //the pawn can advance if the way is empty
-					moves.push_back(move(square, square+8, quietMove, 0));
+					moves.push_back(move(square, square+8, quietMove), 0);
 				}
 				//the pawn can also capture
 				if(hasCaptureLeftSquare && captureLeft > 0) { //enemy piece on the left capture square
 					int captured = std::abs(captureLeft);
-					moves.push_back(move(square, square+7, capture, mvvLvaArray[pawn][captured]));
+					moves.push_back(move(square, square+7, capture), mvvLvaArray[pawn][captured]);
 				}  else if(hasCaptureLeftSquare && (square+7) == gameInfo.getEnPassantSquare(black)) { //en passant capture possible to the left
-					moves.push_back(move(square, square+7, enPassantCapture, mvvLvaArray[pawn][pawn]));
+					moves.push_back(move(square, square+7, enPassantCapture), mvvLvaArray[pawn][pawn]);
 				}
 				if(hasCaptureRightSquare && captureRight > 0) { //enemy piece on the right capture square
 					int captured = std::abs(captureRight);
-					moves.push_back(move(square, square+9, capture, mvvLvaArray[pawn][captured]));
+					moves.push_back(move(square, square+9, capture), mvvLvaArray[pawn][captured]);
 				} else if(hasCaptureRightSquare && (square+9) == gameInfo.getEnPassantSquare(black)) { //en passant capture possible to the right
-					moves.push_back(move(square, square+9, enPassantCapture, mvvLvaArray[pawn][pawn]));
+					moves.push_back(move(square, square+9, enPassantCapture), mvvLvaArray[pawn][pawn]);
 				}
 			}
 		}
 	}
 
-	//Credits to chessprogramming.org for this useful code
-	void move_generator::generatePseudoLegalNonPawnMoves(unsigned int side, unsigned int square, std::vector<move>& moves) const {
+	void move_generator::generatePseudoLegalNonPawnMoves(unsigned int side, unsigned int square, move_list& moves) const {
 		/*
 		 * Depending on the side, this may be negative, but now we wonly care about
 		 * the type of the piece.
 		 */
 		const int piece = std::abs(board[square]);
-		for(unsigned int i=0; i<offsetAmount[piece]; ++i) { //check all the directions (offsets) this piece can move to
-			for (int n = square;;) {
-				n = mailbox[mailbox64[n] + offsets[piece][i]]; //number of the next square in this direction
-			    if (n == -1) break; //square is off the board
-			    if (board[n] != empty) { //there is a piece on this square
-			    	if ( (side==white && board[n] < 0) || (side == black && board[n] > 0) ) { //this piece is an enemy piece
-			    		int captured = std::abs(board[n]);
-			    		moves.push_back(move(square, n, capture, mvvLvaArray[piece][captured]));
-			        }
-			        break; //after capture, or if it was a friendly piece we can not move any more in this direction
-			    }
-			    //there was no piece here, can make a quiet move in this direction
-			    moves.push_back(move(square, n, quietMove, 0));
-			    if (!canSlide[piece]) break; //for non-sliding pieces, we must stop after 1 move in a direction
-			}
-		}
-	}
-
-	void move_generator::generatePseudoLegalNormalMoves(unsigned int side, std::vector<move>& moves) const {
-		int kingCount = 0;
-		if(side == white) { //generate moves for white
-			for(unsigned int square = 0; square < 64; ++square) { //check all squares
-				int piece = board[square];
-				if(piece == 5 || piece == -5) ++kingCount;
-				if(piece > 0 && piece < 7) { //found a white piece
-					if(piece == pawn) { //look for white pawn moves
-						generatePseudoLegalPawnMoves(side, square, moves); //find all moves for this white pawn
-					} else { //look for white's non pawn moves
-						generatePseudoLegalNonPawnMoves(side, square, moves); //find all moves for this white piece
-					}
+		const bitboard occupied = board.getOccupied();
+		bitboard attacks;
+		if(piece == knight) {
+			attacks = knightAttacks[square];
+		} else if(piece == bishop) {
+			attacks = bishopAttacks(square, occupied);
+		} else if(piece == rook) {
+			attacks = rookAttacks(square, occupied);
+		} else if(piece == queen) {
+			attacks = queenAttacks(square, occupied);
+		} else { //must be the king
+			attacks = kingAttacks[square];
+		}
+		//the attacked enemy pieces can be captured
+		bitboard captures = attacks & board.getPieces(1-side);
+		while(captures) {
+			unsigned int n = popLowestSquare(captures);
+			int captured = std::abs(board[n]);
+			moves.push_back(move(square, n, capture), mvvLvaArray[piece][captured]);
+		}
+		//can make a quiet move to the attacked empty squares
+		bitboard quiets = attacks & ~occupied;
+		while(quiets) {
+			moves.push_back(move(square, popLowestSquare(quiets), quietMove), 0);
+		}
+	}
+
+	void move_generator::generatePseudoLegalNormalMoves(unsigned int side, move_list& moves) const {
+		if(popCount(board.getPieces(white, king) | board.getPieces(black, king)) > 2) {
+			throw std::runtime_error("Too many kings!");
+		}
+		//look for pawn moves, including promotions and en passant
+		bitboard pawns = board.getPieces(side, pawn);
+		while(pawns) {
+			generatePseudoLegalPawnMoves(side, popLowestSquare(pawns), moves); //find all moves for this pawn
+		}
+		//look for non pawn moves
+		bitboard pieces = board.getPieces(side) ^ board.getPieces(side, pawn);
+		while(pieces) {
+			generatePseudoLegalNonPawnMoves(side, popLowestSquare(pieces), moves); //find all moves for this piece
+		}
+	}
+
+	/*
+	 * Adds the four promotions of a pawn move. The codes of the knight, bishop, rook and queen promotions
+	 * follow each other, with and without capture too.
+	 */
+	static inline void addPromotions(unsigned int from, unsigned int to, bool isCapture, unsigned int captureScore, move_list& moves) {
+		const unsigned int firstCode = isCapture ? knightPromotionCap : knightPromotion;
+		for(unsigned int promotion = knightPromotion; promotion <= queenPromotion; ++promotion) {
+			moves.push_back(move(from, to, firstCode + promotion - knightPromotion), captureScore + promotionScoreArray[promotion]);
+		}
+	}
+
+	void move_generator::generatePseudoLegalNoisyMoves(unsigned int side, move_list& moves) const {
+		const bitboard enemy = board.getPieces(1-side), occupied = board.getOccupied();
+		const bitboard pawns = board.getPieces(side, pawn);
+		//pawns: the captures and the pushes to the last rank, the offsets lead from the destination back to the pawn
+		bitboard pushes, capturesLeft, capturesRight, promotionRank;
+		int pushOffset, leftOffset, rightOffset;
+		if(side == white) {
+			pushes = (pawns >> 8) & ~occupied;
+			capturesLeft = ((pawns & ~fileBitboards[0]) >> 9) & enemy;
+			capturesRight = ((pawns & ~fileBitboards[7]) >> 7) & enemy;
+			promotionRank = rankBitboards[0];
+			pushOffset = 8; leftOffset = 9; rightOffset = 7;
+		} else {
+			pushes = (pawns << 8) & ~occupied;
+			capturesLeft = ((pawns & ~fileBitboards[0]) << 7) & enemy;
+			capturesRight = ((pawns & ~fileBitboards[7]) << 9) & enemy;
+			promotionRank = rankBitboards[7];
+			pushOffset = -8; leftOffset = -7; rightOffset = -9;
+		}
+		pushes &= promotionRank;
+		while(pushes) {
+			unsigned int to = popLowestSquare(pushes);
+			addPromotions(to + pushOffset, to, false, 0, moves);
+		}
+		for(unsigned int direction = 0; direction < 2; ++direction) {
+			bitboard captures = direction == 0 ? capturesLeft : capturesRight;
+			const int offset = direction == 0 ? leftOffset : rightOffset;
+			while(captures) {
+				unsigned int to = popLowestSquare(captures);
+				const unsigned int score = mvvLvaArray[pawn][std::abs(board[to])];
+				if(squareBitboard(to) & promotionRank) {
+					addPromotions(to + offset, to, true, score, moves);
+				} else {
+					moves.push_back(move(to + offset, to, capture), score);
 				}
 			}
-		} else { //generate moves for black
-			for(unsigned int square = 0; square < 64; ++square) { //check all squares
-				int piece = board[square];
-				if(piece == 5 || piece == -5) ++kingCount;
-				if(piece < 0) { //found a black piece
-					if(piece == -1) { //look for black pawn moves (using -1 to eliminate warning)
-						generatePseudoLegalPawnMoves(side, square, moves); //find all moves for black pawn
-					} else { //look for black's non pawn moves
-						generatePseudoLegalNonPawnMoves(side, square, moves); //find all moves for this black piece
-					}
-				}
+		}
+		int enPassantSquare = (int)gameInfo.getEnPassantSquare(side);
+		if(enPassantSquare != noEnPassant) { //the pawns that attack the en passant square
+			bitboard capturers = pawnAttacks[1-side][enPassantSquare] & pawns;
+			while(capturers) {
+				moves.push_back(move(popLowestSquare(capturers), enPassantSquare, enPassantCapture), mvvLvaArray[pawn][pawn]);
 			}
 		}
-		if(kingCount > 2) {
-			throw std::runtime_error("Too many kings!");
+		//other pieces: the attacked enemy pieces
+		bitboard pieces = board.getPieces(side) ^ pawns;
+		while(pieces) {
+			unsigned int square = popLowestSquare(pieces);
+			const int piece = std::abs(board[square]);
+			bitboard attacks;
+			if(piece == knight) {
+				attacks = knightAttacks[square];
+			} else if(piece == bishop) {
+				attacks = bishopAttacks(square, occupied);
+			} else if(piece == rook) {
+				attacks = rookAttacks(square, occupied);
+			} else if(piece == queen) {
+				attacks = queenAttacks(square, occupied);
+			} else {
+				attacks = kingAttacks[square];
+			}
+			bitboard captures = attacks & enemy;
+			while(captures) {
+				unsigned int n = popLowestSquare(captures);
+				moves.push_back(move(square, n, capture), mvvLvaArray[piece][std::abs(board[n])]);
+			}
 		}
 	}
 
-	void move_generator::generatePseudoLegalCastleMoves(unsigned int side, std::vector<move>& moves) const {
+	void move_generator::generatePseudoLegalCastleMoves(unsigned int side, move_list& moves) const {
 		if(side == white) { //make castling moves for white
 			if(gameInfo.getKingsideCastleRights(white)) { //look for kingside castle, if white still has the right
 				if(board[60] == 5 && board[61] == empty && board[62] == empty && board[63] == 4) {
-					moves.push_back(move(60,62,kingsideCastle, 0));
+					moves.push_back(move(60,62,kingsideCastle), 0);
 				}
 			}
 			if(gameInfo.getQueensideCastleRights(white)) { //look for kingside castle, if white still has the right
 				if(board[56] == 4 && board[57] == empty &&
 						board[58] == empty && board[59] == empty && board[60] == 5) {
-					moves.push_back(move(60,58,queensideCastle, 0));
+					moves.push_back(move(60,58,queensideCastle), 0);
 				}
 			}
 		} else { //make castling moves for black
 			if(gameInfo.getKingsideCastleRights(black)) { //look for kingside castle, if black still has the right
 				if(board[4] == -5 && board[5] == empty && board[6] == empty && board[7] == -4) {
-					moves.push_back(move(4,6,kingsideCastle, 0));
+					moves.push_back(move(4,6,kingsideCastle), 0);
 				}
 			}
 			if(gameInfo.getQueensideCastleRights(black)) { //look for kingside castle, if black still has the right
 				if(board[0] == -4 && board[1] == empty &&
 						board[2] == empty && board[3] == empty && board[4] == -5) {
-					moves.push_back(move(4,2,queensideCastle, 0));
+					moves.push_back(move(4,2,queensideCastle), 0);
 				}
 			}
 		}
 	}
 
 	void move_generator::generatePseudoLegalMoves(unsigned int side, std::vector<move>& moves) const {
+		move_list list;
+		generatePseudoLegalMoves(side, list);
+		moves.assign(list.begin(), list.end());
+	}
+
+	void move_generator::generatePseudoLegalMoves(unsigned int side, move_list& moves) const {
 		moves.clear(); //empty list
 		generatePseudoLegalNormalMoves(side, moves); //add normal moves
 		generatePseudoLegalCastleMoves(side, moves); //add castling moves
 	}
 
-	static const int pawnAttackOffsets[2][2] = {
-			{9, 11}, // <-- for white
-			{-9, -11} // <-- for black
-	};
-
-	bool isAttacked(const chessboard& board, unsigned int side, unsigned int square) { //side is the attacker side
-		bool attacked = false;
-		/*
-		 * To determine if the square is attacked I will look at all directions from that square. Can
-		 * get all directions by looking at the QUEEN + KNIGHT offsets. The queen's offsets will be sliding,
-		 * the knight's will not be.
-		 */
-		static int pieces[2] = {queen, knight};
-		for(int p = 0; p < 2; ++p) {
-			int piece = pieces[p];
-			for(unsigned int i=0; i<offsetAmount[piece]; ++i) { //check all the directions (offsets) this piece can move to
-				unsigned int distance = 0; //the "distance" we have moved on the current direction (also 1 for a knight move)
-				int direction = offsets[piece][i]; //the direction where we are checking threats
-
-				for (int n = square;;) {
-					n = mailbox[mailbox64[n] + direction]; //number of the next square in this direction
-
-					if (n == -1) break; //square is off the board
-					//std::cout << "Next square in " << direction << " direction:" << createSquareName(n) << std::endl;
-					++distance; //there is a square in this direction, so increase the distance
-
-					if (board[n] != empty) { //there is a piece on this square
-						if ( (side==white && board[n] > 0) || (side == black && board[n] < 0) ) { //this piece is an enemy piece (because 'side' is the attacker)
-
-							//std::cout << "Enemy piece found in direction " << direction << ": " << board[n] << std::endl;
-							/*
-							 * There is a direction from the attacked square to an enemy piece. Depending on the distance and the
-							 * type of the enemy piece, it may be able to attack this square. For example, if the direction is diagonal
-							 * then a a bishop or a pawn can attack but a pawn only if the distance is 1 (and only from 2 diagonals).
-							 */
-							const unsigned int enemyPiece = board[n] >= 0 ? board[n] : -board[n]; //type of the enemy piece that may be attacking
-							if(enemyPiece == pawn) { //pawns need special care, because they can only attack on 2 diagonals, depending on the side
-								if(distance==1 && (direction == pawnAttackOffsets[side][0] || direction == pawnAttackOffsets[side][1])) {
-									//the enemy pawn is 1 square away and on a diagonal from where it can attack
-									//std::cout << "Attacking pawn found on square " << createSquareName(n) << " (distance " << distance << ")" << std::endl;
-									return  true;
-								}
-							} else { //non pawn pieces
-								if(canSlide[enemyPiece]) { //sliding piece, so distance does not matter
-									for(unsigned int k = 0; k<offsetAmount[enemyPiece]; ++k) { //check all direction the enemy piece can attack on
-										if(direction == offsets[enemyPiece][k]) { //if the enemy sliding piece has the direction we are checking, then it can attack
-											//std::cout << "Attacking sliding piece found" << std::endl;
-											return true;
-										}
-									}
-								} else { //this is a non sliding piece
-									if(distance == 1) { //can only threaten if the distance is 1
-										for(unsigned int k = 0; k<offsetAmount[enemyPiece]; ++k) { //check all direction the enemy piece can attack on
-											if(direction == offsets[enemyPiece][k]) { //if the enemy piece has the direction we are checking, then it can attack
-												//std::cout << "Attacking non-sliding piece found" << std::endl;
-												return true;
-											}
-										}
-									}
-								}
-							}
-						}
-						break; //any other pieces in this direction can't attack the square
-					}
-					if (!canSlide[piece]) break; //for non-sliding pieces, we must stop after 1 move in a direction
-				}
-			}
+	bool move_generator::isPseudoLegalMove(unsigned int side, const move& m) const {
+		unsigned int from = m.getFromSquare();
+		if(from > 63 || m.getToSquare() > 63 || !(board.getPieces(side) & squareBitboard(from))) {
+			return false; //not our piece that moves
+		}
+		move_list moves;
+		if(m.isKingsideCastle() || m.isQueensideCastle()) {
+			generatePseudoLegalCastleMoves(side, moves);
+		} else if(std::abs(board[from]) == pawn) {
+			generatePseudoLegalPawnMoves(side, from, moves);
+		} else {
+			generatePseudoLegalNonPawnMoves(side, from, moves);
 		}
-		return attacked;
+		return std::find(moves.begin(), moves.end(), m) != moves.end();
 	}
 
-	bool isLegalMove(const move& playerMove, chessboard& board, const game_information& info) {
-		bool legal = false;
-		unsigned int side = info.getSideToMove();
-		unsigned int enemySide = 1 - side;
-		int capturedPiece = board.makeMove(playerMove, side); //make this move on the board
-		if(playerMove.isKingsideCastle()) {
-			if(info.getKingsideCastleRights(side)) {
-				//for castle, not only king safety needs to be checked, but also the king cant move through attacked squares
-				if(!isAttacked(board, enemySide, playerMove.getFromSquare()) && // <-- check that king did not castle out of check
-				   !isAttacked(board, enemySide, playerMove.getFromSquare()+1) && // <-- check that king did not castle through check
-				   !isAttacked(board, enemySide, playerMove.getFromSquare()+2)) { // <-- check that king did not castle into check
-					//the king is safe and did not catle out/through attacked squares
-					legal = true;
-				}
+	unsigned int move_generator::countPseudoLegalMoves(unsigned int side) const {
+		const bitboard own = board.getPieces(side), enemy = board.getPieces(1-side), emptySquares = ~board.getOccupied();
+		const bitboard pawns = board.getPieces(side, pawn);
+		unsigned int count = 0;
+		//pawns: the same moves as in generatePseudoLegalPawnMoves, a promotion counts as 4 moves
+		bitboard pushes, doublePushes, capturesLeft, capturesRight, promotionRank;
+		if(side == white) {
+			pushes = (pawns >> 8) & emptySquares;
+			doublePushes = ((pushes & rankBitboards[5]) >> 8) & emptySquares;
+			capturesLeft = ((pawns & ~fileBitboards[0]) >> 9) & enemy;
+			capturesRight = ((pawns & ~fileBitboards[7]) >> 7) & enemy;
+			promotionRank = rankBitboards[0];
+		} else {
+			pushes = (pawns << 8) & emptySquares;
+			doublePushes = ((pushes & rankBitboards[2]) << 8) & emptySquares;
+			capturesLeft = ((pawns & ~fileBitboards[0]) << 7) & enemy;
+			capturesRight = ((pawns & ~fileBitboards[7]) << 9) & enemy;
+			promotionRank = rankBitboards[7];
+		}
+		count += popCount(pushes & ~promotionRank) + 4 * popCount(pushes & promotionRank) + popCount(doublePushes);
+		count += popCount(capturesLeft & ~promotionRank) + 4 * popCount(capturesLeft & promotionRank);
+		count += popCount(capturesRight & ~promotionRank) + 4 * popCount(capturesRight & promotionRank);
+		int enPassantSquare = (int)gameInfo.getEnPassantSquare(side);
+		if(enPassantSquare != noEnPassant) { //the pawns that attack the en passant square
+			count += popCount(pawnAttacks[1-side][enPassantSquare] & pawns);
+		}
+		//other pieces: every attacked square that is not ours
+		const bitboard occupied = board.getOccupied();
+		bitboard pieces = own ^ pawns;
+		while(pieces) {
+			unsigned int square = popLowestSquare(pieces);
+			const int piece = std::abs(board[square]);
+			bitboard attacks;
+			if(piece == knight) {
+				attacks = knightAttacks[square];
+			} else if(piece == bishop) {
+				attacks = bishopAttacks(square, occupied);
+			} else if(piece == rook) {
+				attacks = rookAttacks(square, occupied);
+			} else if(piece == queen) {
+				attacks = queenAttacks(square, occupied);
+			} else {
+				attacks = kingAttacks[square];
 			}
-		} else if(playerMove.isQueensideCastle()) {
-			//for castle, not only king safety needs to be checked, but also the king cant move through attacked squares
-			if(info.getQueensideCastleRights(side)) {
-				if(!isAttacked(board, enemySide, playerMove.getFromSquare()) && // <-- check that king did not castle out of check
-					   !isAttacked(board, enemySide, playerMove.getFromSquare()-1) && // <-- check that king did not castle through check
-					   !isAttacked(board, enemySide, playerMove.getFromSquare()-2)) { // <-- check that king did not castle into check
-					//the king is safe and did not catle out/through attacked squares
-					legal = true;
-				}
+			count += popCount(attacks & ~own);
+		}
+		//castling, with the same conditions as generatePseudoLegalCastleMoves
+		const unsigned int kingSquare = side == white ? 60 : 4;
+		const int sign = side == white ? 1 : -1;
+		if(board[kingSquare] == sign * (int)king) {
+			if(gameInfo.getKingsideCastleRights(side) && board[kingSquare+1] == empty && board[kingSquare+2] == empty
+					&& board[kingSquare+3] == sign * (int)rook) {
+				++count;
 			}
-		} else {
-			//not a castle, only king safety is important
-			if(!isAttacked(board, enemySide, board.getKingSquare(side))) {
-				//the king is safe after this move
-				legal = true;
+			if(gameInfo.getQueensideCastleRights(side) && board[kingSquare-1] == empty && board[kingSquare-2] == empty
+					&& board[kingSquare-3] == empty && board[kingSquare-4] == sign * (int)rook) {
+				++count;
 			}
 		}
-		board.unmakeMove(playerMove, side, capturedPiece);
-		return legal;
+		return count;
 	}
 
-	//Helper method that checks 
-	bool isLightSquare(unsigned int square) {
-		//detemine rank and file
-		unsigned int rank = square / 8;
-		unsigned int file = square % 8;
-		if (rank % 2 == 0) {
-			if (file % 2 == 0) {
-				return true;
-			}
-			else {
-				return false;
+	check_info move_generator::findChecksAndPins(unsigned int side) const {
+		check_info checks;
+		const unsigned int enemySide = 1 - side;
+		const bitboard occupied = board.getOccupied();
+		checks.kingSquare = board.getKingSquare(side);
+		checks.checkers = attackersOf(board, enemySide, checks.kingSquare, occupied);
+		checks.pinned = emptyBitboard;
+		//enemy sliding pieces that would see the king on an empty board, with exactly one own piece in between
+		const bitboard queens = board.getPieces(enemySide, queen);
+		bitboard snipers = (rookAttacks(checks.kingSquare, emptyBitboard) & (board.getPieces(enemySide, rook) | queens))
+				| (bishopAttacks(checks.kingSquare, emptyBitboard) & (board.getPieces(enemySide, bishop) | queens));
+		while(snipers) {
+			const bitboard between = betweenBitboards[checks.kingSquare][popLowestSquare(snipers)] & occupied;
+			if(between && !(between & (between - 1)) && (between & board.getPieces(side))) {
+				checks.pinned |= between;
 			}
 		}
-		else {
-			if (file % 2 == 0) {
-				return false;
+		if(checks.checkers == emptyBitboard) {
+			checks.evasionSquares = ~emptyBitboard;
+		} else { //in double check this is not used, only the king can move
+			checks.evasionSquares = checks.checkers | betweenBitboards[checks.kingSquare][bitScanForward(checks.checkers)];
+		}
+		return checks;
+	}
+
+	bool move_generator::isLegalPseudoLegalMove(unsigned int side, const move& m, const check_info& checks) const {
+		const unsigned int from = m.getFromSquare(), to = m.getToSquare(), enemySide = 1 - side;
+		if(from == checks.kingSquare) {
+			if(m.isKingsideCastle() || m.isQueensideCastle()) {
+				//can't castle out of, through or into check
+				if(checks.checkers) return false;
+				const int step = m.isKingsideCastle() ? 1 : -1;
+				return !isAttacked(board, enemySide, from + step) && !isAttacked(board, enemySide, from + 2 * step);
 			}
-			else {
-				return true;
+			//the king is not in the way of the attacks on its destination
+			return attackersOf(board, enemySide, to, board.getOccupied() ^ squareBitboard(from)) == emptyBitboard;
+		}
+		if(checks.checkers & (checks.checkers - 1)) return false; //double check, only the king can move
+		if(m.isEnPassant()) {
+			/*
+			 * Two pawns leave the rank of the capturing pawn at the same time, so a pin can't be seen from the
+			 * pinned pieces. Look at the slider attacks on the king with the occupancy after the capture instead.
+			 */
+			const unsigned int capturedSquare = side == white ? to + 8 : to - 8;
+			const bitboard occupied = (board.getOccupied() ^ squareBitboard(from) ^ squareBitboard(capturedSquare)) | squareBitboard(to);
+			const bitboard queens = board.getPieces(enemySide, queen);
+			if(checks.checkers & ~squareBitboard(capturedSquare) & (board.getPieces(enemySide, knight) | board.getPieces(enemySide, pawn))) {
+				return false; //the check of a knight or another pawn remains
 			}
+			return !(rookAttacks(checks.kingSquare, occupied) & (board.getPieces(enemySide, rook) | queens))
+					&& !(bishopAttacks(checks.kingSquare, occupied) & (board.getPieces(enemySide, bishop) | queens));
+		}
+		//a pinned piece may only move along the line of the pin
+		if((checks.pinned & squareBitboard(from)) && !(lineBitboards[checks.kingSquare][from] & squareBitboard(to))) {
+			return false;
 		}
+		return (checks.evasionSquares & squareBitboard(to)) != emptyBitboard;
 	}
 
-	void drawBoard(const chessboard& board, std::vector<CPictureCtrl>& squareControls)
-	{
-		for (unsigned int square = 0; square < 64; ++square) {
-			if (isLightSquare(square)) {
-				//we are on a light square
-				if (board[square] > 0) {
-					//white piece
-					unsigned int piece = board[square];
-					squareControls[square].Load(light_white_images[piece].data(), light_white_images[piece].size());
-				}
-				else if (board[square] < 0) {
-					//black piece
-					unsigned int piece = std::abs(board[square]);
-					squareControls[square].Load(light_black_images[piece].data(), light_black_images[piece].size());
-				}
-				else {
-					//empty square
-					squareControls[square].Load(light_white_images[empty].data(), light_white_images[empty].size());
+	void move_generator::keepLegalMoves(unsigned int side, move_list& moves, const check_info& checks) const {
+		//keep the legal moves in their order, with their scores
+		unsigned int legalCount = 0;
+		for(unsigned int i = 0; i < moves.size(); ++i) {
+			if(isLegalPseudoLegalMove(side, moves[i], checks)) {
+				if(i != legalCount) {
+					moves[legalCount] = moves[i];
+					moves.setScore(legalCount, moves.getScore(i));
 				}
+				++legalCount;
 			}
-			else {
-				//we are on a dark square
-				if (board[square] > 0) {
-					//white piece
-					unsigned int piece = board[square];
-					squareControls[square].Load(dark_white_images[piece].data(), dark_white_images[piece].size());
-				}
-				else if (board[square] < 0) {
-					//black piece
-					unsigned int piece = std::abs(board[square]);
-					squareControls[square].Load(dark_black_images[piece].data(), dark_black_images[piece].size());
-				}
-				else {
-					//empty square
-					squareControls[square].Load(dark_white_images[empty].data(), dark_white_images[empty].size());
-				}
+		}
+		moves.truncate(legalCount);
+	}
+
+	void move_generator::generateLegalMoves(unsigned int side, move_list& moves) const {
+		const check_info checks = findChecksAndPins(side);
+		if(checks.checkers & (checks.checkers - 1)) { //double check: only the king moves
+			moves.clear();
+			generatePseudoLegalNonPawnMoves(side, checks.kingSquare, moves);
+		} else {
+			generatePseudoLegalMoves(side, moves);
+		}
+		keepLegalMoves(side, moves, checks);
+	}
+
+	void move_generator::generateLegalNoisyMoves(unsigned int side, move_list& moves) const {
+		const check_info checks = findChecksAndPins(side);
+		moves.clear();
+		generatePseudoLegalNoisyMoves(side, moves);
+		keepLegalMoves(side, moves, checks);
+	}
+
+	void move_generator::generateLegalMoves(unsigned int side, std::vector<move>& moves) const {
+		move_list list;
+		generateLegalMoves(side, list);
+		moves.assign(list.begin(), list.end());
+	}
+
+	bool move_generator::isLegalMove(unsigned int side, const move& m) const {
+		return isPseudoLegalMove(side, m) && isLegalPseudoLegalMove(side, m, findChecksAndPins(side));
+	}
+
+	bool move_generator::hasAnyLegalMove(unsigned int side) const {
+		const check_info checks = findChecksAndPins(side);
+		const bitboard own = board.getPieces(side);
+		//king steps first, they are the only moves in double check (castling is only legal if a step is too)
+		const bitboard occupiedWithoutKing = board.getOccupied() ^ squareBitboard(checks.kingSquare);
+		bitboard kingTargets = kingAttacks[checks.kingSquare] & ~own;
+		while(kingTargets) {
+			if(attackersOf(board, 1-side, popLowestSquare(kingTargets), occupiedWithoutKing) == emptyBitboard) return true;
+		}
+		if(checks.checkers & (checks.checkers - 1)) return false;
+		//pieces: a pseudo legal target on the evasion squares, and on the pin line if pinned
+		const bitboard occupied = board.getOccupied();
+		bitboard pieces = own ^ board.getPieces(side, pawn) ^ board.getPieces(side, king);
+		while(pieces) {
+			const unsigned int square = popLowestSquare(pieces);
+			const int piece = std::abs(board[square]);
+			bitboard targets;
+			if(piece == knight) {
+				targets = knightAttacks[square];
+			} else if(piece == bishop) {
+				targets = bishopAttacks(square, occupied);
+			} else if(piece == rook) {
+				targets = rookAttacks(square, occupied);
+			} else {
+				targets = queenAttacks(square, occupied);
+			}
+			targets &= ~own & checks.evasionSquares;
+			if(checks.pinned & squareBitboard(square)) targets &= lineBitboards[checks.kingSquare][square];
+			if(targets) return true;
+		}
+		//pawns have the most special cases, generate their moves one by one
+		move_list pawnMoves;
+		bitboard pawns = board.getPieces(side, pawn);
+		while(pawns) {
+			pawnMoves.clear();
+			generatePseudoLegalPawnMoves(side, popLowestSquare(pawns), pawnMoves);
+			for(const move& m: pawnMoves) {
+				if(isLegalPseudoLegalMove(side, m, checks)) return true;
 			}
 		}
+		return false;
+	}
+
+	bool isAttacked(const chessboard& board, unsigned int side, unsigned int square) { //side is the attacker side
+		/*
+		 * The square is attacked by a piece if that piece would be attacked by the same kind of piece from
+		 * the square. For pawns the attacks of the other side's pawns must be used for this.
+		 */
+		if(pawnAttacks[1-side][square] & board.getPieces(side, pawn)) return true;
+		if(knightAttacks[square] & board.getPieces(side, knight)) return true;
+		if(kingAttacks[square] & board.getPieces(side, king)) return true;
+		const bitboard occupied = board.getOccupied();
+		const bitboard queens = board.getPieces(side, queen);
+		if(bishopAttacks(square, occupied) & (board.getPieces(side, bishop) | queens)) return true;
+		return (rookAttacks(square, occupied) & (board.getPieces(side, rook) | queens)) != emptyBitboard;
+	}
+
+	bitboard attackersOf(const chessboard& board, unsigned int side, unsigned int square, bitboard occupied) { //side is the attacker side
+		const bitboard queens = board.getPieces(side, queen);
+		return (pawnAttacks[1-side][square] & board.getPieces(side, pawn))
+				| (knightAttacks[square] & board.getPieces(side, knight))
+				| (kingAttacks[square] & board.getPieces(side, king))
+				| (bishopAttacks(square, occupied) & (board.getPieces(side, bishop) | queens))
+				| (rookAttacks(square, occupied) & (board.getPieces(side, rook) | queens));
 	}
 }
 
@@ -5,6 +5,9 @@
  *  - Square centric.
  *  - Mailbox: white pices are positive, black pieces are negative, empty square is 0, the sentinel
  *  files and ranks are 7.
+ *  - Piece centric bitboards are kept next to the mailbox, one for each side and piece type (see bitboard.h).
+ *  - The zobrist hash of the pieces is updated with every change of the board (see zobrist.h).
+ *  - So are the piece square table totals of both sides and the game phase (see piece_square.h).
  *
  * The board is a 8x8 array looks like this:
  *  -4 -2 -3 -5 -6 -3 -2 -4  <-- black's backrank
@@ -28,7 +31,10 @@
 #include <utility>
 
 #include "move.h"
-#include "PictureCtrl.h"
+#include "move_list.h"
+#include "bitboard.h"
+#include "zobrist.h"
+#include "piece_square.h"
 
 namespace tchess
 {
@@ -110,16 +116,102 @@ namespace tchess
 		//Squares of the board
 		int squares[64];
 
+		/*
+		 * Bitboards of the pieces. The first index is the side, the second is the (positive) piece
+		 * code, so for example pieceBitboards[black][rook] has the black rooks. Index 0 (empty) is unused.
+		 */
+		bitboard pieceBitboards[2][7];
+
+		//All pieces of a side.
+		bitboard sideBitboards[2];
+
 		/*
 		 * Maintains the location of the king for both sides.
 		 */
 		unsigned int kingSquare[2];
 
+		/*
+		 * Zobrist hash of the pieces on the board. The castling, en passant and side to move
+		 * parts of the position hash are in the game_information.
+		 */
+		uint64 hashKey;
+
+		//Zobrist hash of the pawns only, the key of the pawn hash table.
+		uint64 pawnHashKey;
+
+		//Sum of the middlegame piece square values (material included) of the pieces of each side.
+		int midgameScore[2];
+
+		//Sum of the endgame piece square values (material included) of the pieces of each side.
+		int endgameScore[2];
+
+		//Game phase of the pieces on the board, see piecePhase.
+		unsigned int phase;
+
+		//Builds the bitboards, the hash key and the totals from the squares array. Used by the constructors.
+		void createBitboards();
+
+		/*
+		 * Places a piece to an empty square, updates the mailbox, the bitboards, the hash key and the totals. The piece
+		 * code is negative for black pieces.
+		 */
+		inline void putPiece(unsigned int square, int piece) {
+			const unsigned int side = piece > 0 ? 0 : 1;
+			const unsigned int pieceType = piece > 0 ? piece : -piece;
+			const bitboard bit = squareBitboard(square);
+			squares[square] = piece;
+			pieceBitboards[side][pieceType] |= bit;
+			sideBitboards[side] |= bit;
+			hashKey ^= zobristPieceKey(piece, square);
+			if(pieceType == pawn) pawnHashKey ^= zobristPieceKey(piece, square);
+			midgameScore[side] += midgamePieceSquareValues[side][pieceType][square];
+			endgameScore[side] += endgamePieceSquareValues[side][pieceType][square];
+			phase += piecePhase[pieceType];
+		}
+
+		/*
+		 * Removes the piece from a square, which must not be empty. Updates the
+		 * mailbox, the bitboards, the hash key and the totals.
+		 */
+		inline void removePiece(unsigned int square) {
+			const int piece = squares[square];
+			const unsigned int side = piece > 0 ? 0 : 1;
+			const unsigned int pieceType = piece > 0 ? piece : -piece;
+			const bitboard bit = squareBitboard(square);
+			squares[square] = 0;
+			pieceBitboards[side][pieceType] ^= bit;
+			sideBitboards[side] ^= bit;
+			hashKey ^= zobristPieceKey(piece, square);
+			if(pieceType == pawn) pawnHashKey ^= zobristPieceKey(piece, square);
+			midgameScore[side] -= midgamePieceSquareValues[side][pieceType][square];
+			endgameScore[side] -= endgamePieceSquareValues[side][pieceType][square];
+			phase -= piecePhase[pieceType];
+		}
+
+		/*
+		 * Moves a piece from a square to an empty square. Updates the mailbox,
+		 * the bitboards, the hash key and the piece square totals (the phase does not change).
+		 */
+		inline void movePiece(unsigned int from, unsigned int to) {
+			const int piece = squares[from];
+			const unsigned int side = piece > 0 ? 0 : 1;
+			const unsigned int pieceType = piece > 0 ? piece : -piece;
+			const bitboard fromTo = squareBitboard(from) | squareBitboard(to);
+			squares[from] = 0;
+			squares[to] = piece;
+			pieceBitboards[side][pieceType] ^= fromTo;
+			sideBitboards[side] ^= fromTo;
+			hashKey ^= zobristPieceKey(piece, from) ^ zobristPieceKey(piece, to);
+			if(pieceType == pawn) pawnHashKey ^= zobristPieceKey(piece, from) ^ zobristPieceKey(piece, to);
+			midgameScore[side] += midgamePieceSquareValues[side][pieceType][to] - midgamePieceSquareValues[side][pieceType][from];
+			endgameScore[side] += endgamePieceSquareValues[side][pieceType][to] - endgamePieceSquareValues[side][pieceType][from];
+		}
+
 	public:
 		//Creates a chessboard as it is at the start of the game.
 		chessboard();
 
-		//Creates a chessboard from an array of squares and piece. Only for debug.
+		//Creates a chessboard from an array of squares and pieces. Used by the FEN import, and for debug.
 		chessboard(const int (&squares)[64]);
 
 		/*
@@ -174,6 +266,61 @@ namespace tchess
 		inline unsigned int getKingSquare(unsigned int side) const {
 			return kingSquare[side];
 		}
+
+		/*
+		 * Bitboard of the pieces of a side with the given (positive) piece code.
+		 */
+		inline bitboard getPieces(unsigned int side, unsigned int pieceType) const {
+			return pieceBitboards[side][pieceType];
+		}
+
+		/*
+		 * Bitboard of all pieces of a side.
+		 */
+		inline bitboard getPieces(unsigned int side) const {
+			return sideBitboards[side];
+		}
+
+		/*
+		 * Bitboard of all occupied squares.
+		 */
+		inline bitboard getOccupied() const {
+			return sideBitboards[0] | sideBitboards[1];
+		}
+
+		/*
+		 * Material and piece square table total of a side in the middlegame, with the
+		 * middlegame king table.
+		 */
+		inline int getMidgameScore(unsigned int side) const {
+			return midgameScore[side];
+		}
+
+		//Material and piece square table total of a side in the endgame, with the endgame king table.
+		inline int getEndgameScore(unsigned int side) const {
+			return endgameScore[side];
+		}
+
+		/*
+		 * Game phase of the pieces on the board, maxGamePhase with all pieces (middlegame) down
+		 * to 0 when only pawns and kings are left (endgame).
+		 */
+		inline unsigned int getPhase() const {
+			return phase;
+		}
+
+		/*
+		 * Zobrist hash of the pieces, updated by makeMove and unmakeMove. Combine it with the
+		 * key of the game_information to get the hash of the position (see positionHashKey).
+		 */
+		inline uint64 getHashKey() const {
+			return hashKey;
+		}
+
+		//Zobrist hash of the pawns only, for the pawn hash table of the evaluation.
+		inline uint64 getPawnHashKey() const {
+			return pawnHashKey;
+		}
 	};
 
 	/*
@@ -213,6 +360,18 @@ namespace tchess
 		 */
 		int enPassantCaptureSquares[2];
 
+		/*
+		 * Zobrist hash of the castling rights, the en passant file and the side to move. Updated
+		 * by the setter methods.
+		 */
+		uint64 hashKey;
+
+		//Moves (of both sides) since the last capture or pawn move, for the fifty move rule.
+		unsigned int halfmoveClock;
+
+		//Number of the current full move, starts at 1 and increases after each black move.
+		unsigned int fullmoveNumber;
+
 	public:
 
 		/**
@@ -273,10 +432,29 @@ namespace tchess
 			return hasCastled[side];
 		}
 
+		//Only for unmaking a castling move.
+		inline void clearHasCastled(unsigned int side) {
+			hasCastled[side] = false;
+		}
+
+		//The castle rights in 4 bits: kingside and queenside of white, then of black (the order of their hash keys).
+		inline unsigned int getCastleRights() const {
+			return (unsigned int)kingsideCastleRight[white] | (unsigned int)queensideCastleRight[white] << 1
+					| (unsigned int)kingsideCastleRight[black] << 2 | (unsigned int)queensideCastleRight[black] << 3;
+		}
+
+		/*
+		 * Sets back what a move of the side changed, for unmaking it: the side is to move again with the castle
+		 * rights (from getCastleRights), en passant square, hash key and halfmove clock it had. Only the side to move can
+		 * have an en passant square. The hash key is not updated, it is set with the rest.
+		 */
+		void restore(unsigned int side, unsigned int castleRights, int enPassantSquare, uint64 hashKey, unsigned int halfmoveClock);
+
 		/**
 		 * Update the side to move variable.
 		 */
 		inline void setSideToMove(unsigned int side) {
+			if(side != sideToMove) hashKey ^= Random64[sideKeyOffset];
 			sideToMove = side;
 		}
 
@@ -286,18 +464,75 @@ namespace tchess
 		inline unsigned int getSideToMove() const {
 			return sideToMove;
 		}
+
+		/*
+		 * Zobrist hash of the castling rights, the en passant file and the side to move.
+		 */
+		inline uint64 getHashKey() const {
+			return hashKey;
+		}
+
+		inline unsigned int getHalfmoveClock() const {
+			return halfmoveClock;
+		}
+
+		inline void setHalfmoveClock(unsigned int clock) {
+			halfmoveClock = clock;
+		}
+
+		inline unsigned int getFullmoveNumber() const {
+			return fullmoveNumber;
+		}
+
+		inline void setFullmoveNumber(unsigned int number) {
+			fullmoveNumber = number;
+		}
 	};
 
+	/*
+	 * The zobrist hash of a position, made from the incrementally updated keys of the board and
+	 * the game information. This is the same as what createZobrishHash computes from scratch.
+	 */
+	inline uint64 positionHashKey(const chessboard& board, const game_information& info) {
+		return board.getHashKey() ^ info.getHashKey();
+	}
+
 	/*
 	 * This method will modify the 'info' object after a move. For example if a side has moved their king
 	 * then they will loose castle rights.
 	 * Includes:
 	 *  - Update side to move to the next side.
-	 *  - Update castling rights.
+	 *  - Update castling rights: a move from or to the home square of a king or a rook loses
+	 *    the rights that depend on it. Only the squares of the move are looked at.
 	 *  - Update en passant attack squares.
+	 *  - Update the halfmove clock and the fullmove number.
+	 * The move must already be made on the board.
 	 */
 	void updateGameInformation(const chessboard& board, const move& m, game_information& info);
 
+	/*
+	 * What restricts the moves of a side because of its king: the enemy pieces that give check, and
+	 * the own pieces that are pinned to the king. Calculated once for a position, then every move is
+	 * checked against it.
+	 */
+	struct check_info {
+
+		//Square of the king of the side.
+		unsigned int kingSquare;
+
+		//Enemy pieces that attack the king.
+		bitboard checkers;
+
+		//Own pieces that can't leave the line between the king and an enemy sliding piece.
+		bitboard pinned;
+
+		/*
+		 * Squares where a piece other than the king must move in single check: the checker and the
+		 * squares between it and the king. Every square when not in check.
+		 */
+		bitboard evasionSquares;
+	};
+
 	/*
 	 * This class creates moves from a chessboard and the side to move.
 	 */
@@ -328,30 +563,97 @@ namespace tchess
 		 */
 		void generatePseudoLegalMoves(unsigned int side, std::vector<move>&) const;
 
+		/*
+		 * Same as the above, but fills a fixed capacity move list, which does not allocate. The
+		 * search uses this one.
+		 */
+		void generatePseudoLegalMoves(unsigned int side, move_list&) const;
+
+		/*
+		 * Checks if a move is pseudo legal for the side, by generating only the moves of the piece
+		 * on its departure square. Moves that come from somewhere else than the move generator (for example
+		 * from the transposition table) can be checked with this before they are made on the board.
+		 */
+		bool isPseudoLegalMove(unsigned int side, const move& m) const;
+
+		/*
+		 * Counts the pseudo legal moves of the side, without generating them. The result is the
+		 * same as the size of the list from generatePseudoLegalMoves. Used for the mobility in the evaluation.
+		 */
+		unsigned int countPseudoLegalMoves(unsigned int side) const;
+
+		/*
+		 * Generates only the legal moves of the side. The checkers and the pinned pieces are found once,
+		 * and a pseudo legal move is kept only if it respects them. There is no need to make the moves on the board.
+		 * In double check only king moves are generated. The list will be cleared before.
+		 */
+		void generateLegalMoves(unsigned int side, move_list&) const;
+
+		//Same as the above, but fills a vector.
+		void generateLegalMoves(unsigned int side, std::vector<move>&) const;
+
+		/*
+		 * Generates only the legal captures and promotions of the side (also en passant and the promotions
+		 * without capture), with the same scores as the full generation. The quiet moves are not generated at all,
+		 * this is for the quiescence search. The list will be cleared before.
+		 */
+		void generateLegalNoisyMoves(unsigned int side, move_list&) const;
+
+		/*
+		 * Checks if a move is legal for the side. The move does not need to come from the
+		 * move generator, it is first checked to be pseudo legal.
+		 */
+		bool isLegalMove(unsigned int side, const move& m) const;
+
+		/*
+		 * Checks if the side has at least one legal move, without generating all of them. King moves are
+		 * tried first, then the moves of the other pieces. Used to find checkmate and stalemate.
+		 */
+		bool hasAnyLegalMove(unsigned int side) const;
+
+		//Finds the pieces that give check to the king of the side and the pieces pinned to it.
+		check_info findChecksAndPins(unsigned int side) const;
+
+		/*
+		 * Checks if a pseudo legal move of the side respects the checks and pins. King moves and en passant
+		 * captures look at the attacks with the occupancy after the move, so a king can't step back along the ray
+		 * of a checker, and an en passant capture can't open a rank for an enemy rook.
+		 */
+		bool isLegalPseudoLegalMove(unsigned int side, const move& m, const check_info& checks) const;
+
 	private:
 
 		/*
 		 * This method will generate all pseudo legal moves for 1 pawn, on the given square.
 		 * It is checked by the called of this method that there is a pawn on this square.
 		 */
-		void generatePseudoLegalPawnMoves(unsigned int side, unsigned int square, std::vector<move>&) const;
+		void generatePseudoLegalPawnMoves(unsigned int side, unsigned int square, move_list&) const;
 
 		/**
 		 * Generates all pseudo legal moves for a non pawn piece. IT is checked by the called of
 		 * this method that there is a non pawn piece on this square
 		 */
-		void generatePseudoLegalNonPawnMoves(unsigned int side, unsigned int square, std::vector<move>&) const;
+		void generatePseudoLegalNonPawnMoves(unsigned int side, unsigned int square, move_list&) const;
 
 		/**
 		 * Generates all pawn moves, including en passant captures and promotions.
 		 */
-		void generatePseudoLegalNormalMoves(unsigned int side, std::vector<move>&) const;
+		void generatePseudoLegalNormalMoves(unsigned int side, move_list&) const;
+
+		//Removes the moves that don't respect the checks and pins from the pseudo legal moves, keeping the order and the scores.
+		void keepLegalMoves(unsigned int side, move_list&, const check_info& checks) const;
+
+		/*
+		 * Generates the pseudo legal captures and promotions, for all pieces. The pawn moves are found for
+		 * all pawns at once from the bitboards.
+		 */
+		void generatePseudoLegalNoisyMoves(unsigned int side, move_list&) const;
 
 		/**
 		 * Generates kingside and queenside castling moves. Pseudo legal means here that it it
 		 * not checked whether the king is in check when castling or if it passes through attacked fields.
 		 */
-		void generatePseudoLegalCastleMoves(unsigned int side, std::vector<move>&) const;
+		void generatePseudoLegalCastleMoves(unsigned int side, move_list&) const;
 	};
 
 	/*
@@ -359,14 +661,11 @@ namespace tchess
 	 */
 	bool isAttacked(const chessboard& board, unsigned int attackingSide, unsigned int square);
 
-	/**
-	 * This method checks if a move is legal. It will take into consideration the board and
-	 * the game_information object. It is assumed that the move is at least PSEUDO LEGAL!!!
-	 *
-	 * The game class has a similar method, but that one returns additional information as well, this is faster
-	 * and used by the player agents who dont need information about why a move is not legal.
+	/*
+	 * The pieces of the attacking side that attack the square, if the given squares were occupied. With
+	 * a changed occupancy this tells what attacks the square after a piece has moved away.
 	 */
-	bool isLegalMove(const move& m, chessboard& board, const game_information& info);
+	bitboard attackersOf(const chessboard& board, unsigned int attackingSide, unsigned int square, bitboard occupied);
 
 	/*
 	 * Will create a readable representation of a field, such as b5. For example,
@@ -381,9 +680,15 @@ namespace tchess
 	unsigned int createSquareNumber(const std::string& squareName);
 
 	/*
-	 * Draws the given board in the GUI. The vector of picture controls is used to access the rectangles where the squares will be drawn.
+	 * Sets up the board and the game information from a position in FEN (Forsyth-Edwards notation), for example
+	 * "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1" is the start position. The halfmove clock and the
+	 * fullmove number may be left out. Castling rights are only kept if the king and the rook are on their
+	 * home squares. Throws runtime_error if the FEN is invalid, or doesn't have exactly one king for each side.
 	 */
-	void drawBoard(const chessboard& board, std::vector<CPictureCtrl>& squareControls);
+	void loadFen(const std::string& fen, chessboard& board, game_information& info);
+
+	//Creates the FEN of the position, the inverse of loadFen.
+	std::string createFen(const chessboard& board, const game_information& info);
 }
 
 #endif /* SRC_BOARD_BOARD_H_ */
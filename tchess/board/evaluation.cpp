@@ -191,7 +191,7 @@ namespace tchess
 		if(!legalMoves) {
 			bool inCheck = isAttacked(board, 1-side, board.getKingSquare(side));
 			if(inCheck) {
-				return {true, WORST_VALUE - depth};
+				return {true, WORST_VALUE + depth}; //a later mate is less bad, so that the winner prefers the quickest mate
 			} else {
 				return {true, 0};
 			}
@@ -199,40 +199,38 @@ namespace tchess
 		return {false, 0};
 	}
 
-	static unsigned int pieceMaterial[7] = {0, 1, 3, 3, 5, 0, 9};
+	const unsigned int piecePhase[7] = {0, 0, 1, 1, 2, 0, 4};
 
-	bool isEndgame(const chessboard& board) {
-		unsigned int materialWhite = 0, materialBlack = 0;
-		for(unsigned int square = 0; square < 64; ++square) {
-			int piece = board[square];
-			if(piece != 0) {
-				int pieceType = piece > 0 ? piece : -piece;
-				if(piece > 0) { //white piece
-					materialWhite += pieceMaterial[pieceType];
-				} else { //black piece
-					materialBlack += pieceMaterial[pieceType];
+	int midgamePieceSquareValues[2][7][64];
+
+	int endgamePieceSquareValues[2][7][64];
+
+	//Fills the piece square values of the chessboard totals from the piece values and the tables.
+	static bool initPieceSquareValues() {
+		const int (*midgameTables[7])[64] = { nullptr, pawnTable, knightTable, bishopTable, rookTable, kingTable, queenTable };
+		for(unsigned int side = 0; side < 2; ++side) {
+			for(unsigned int pieceType = pawn; pieceType <= queen; ++pieceType) {
+				for(unsigned int square = 0; square < 64; ++square) {
+					int value = pieceValues[pieceType] + midgameTables[pieceType][side][square];
+					midgamePieceSquareValues[side][pieceType][square] = value;
+					endgamePieceSquareValues[side][pieceType][square] = pieceType == king ?
+							pieceValues[king] + kingEndgameTable[side][square] : value;
 				}
 			}
 		}
-		return materialWhite <= 13 && materialBlack <= 13;
+		return true;
 	}
 
+	static const bool pieceSquareValuesReady = initPieceSquareValues();
+
 	/*
 	 * Will count from how many diagonals a bishop is locked in BY PAWNS. The less the better
 	 */
 	int bishopLockedFactor(unsigned int square, const chessboard& board) {
-		int pawnsAround = 0;
-		for(unsigned int i=0; i<offsetAmount[bishop]; ++i) {
-			int direction = offsets[bishop][i];
-			for (int n = square;;) {
-				n = mailbox[mailbox64[n] + direction]; //next square in this direction
-				if(board[n] == 1 || board[n] == -1) { //a pawn found
-					++pawnsAround;
-				}
-				break;
-			}
-		}
-		return pawnsAround;
+		//the diagonal neighbours are the neighbours that are not on the same file or rank
+		bitboard diagonalNeighbours = kingAttacks[square] & ~fileBitboards[square % 8] & ~rankBitboards[square / 8];
+		bitboard pawns = board.getPieces(white, pawn) | board.getPieces(black, pawn);
+		return popCount(diagonalNeighbours & pawns);
 	}
 
 	/*
@@ -241,19 +239,9 @@ namespace tchess
 	 * Returns how good the situation is for "side".
 	 */
 	int rookFileEvaluation(unsigned int side, unsigned int square, const chessboard& board) {
-		bool foundOwnPawn = false, foundEnemyPawn = false;
-		int ownPawn = side==white ? 1 : -1;
-		int enemyPawn = side==white ? -1 : 1;
-		int file = square % 8;
-		for(int i = 0; i < 8; ++i) { //iterate file
-			unsigned int squareInFile = 8 * i + file;
-			int piece = board[squareInFile];
-			if(piece == ownPawn) {
-				foundOwnPawn = true;
-			} else if(piece == enemyPawn) {
-				foundEnemyPawn = true;
-			}
-		}
+		const bitboard file = fileBitboards[square % 8];
+		bool foundOwnPawn = (board.getPieces(side, pawn) & file) != emptyBitboard;
+		bool foundEnemyPawn = (board.getPieces(1-side, pawn) & file) != emptyBitboard;
 		if(!foundOwnPawn && !foundEnemyPawn) { //rook on an open file
 			return 10;
 		} else if(!foundOwnPawn && foundEnemyPawn) {
@@ -268,35 +256,7 @@ namespace tchess
 	 * or the files right next to it.
 	 */
 	bool isPassedPawn(unsigned int side, unsigned int square, const chessboard& board) {
-		int file = square % 8;
-		int enemyPawn = side==white ? -1 : 1;
-		int dirForward = side == white ? -10 : 10;
-		for (int n = square;;) {
-			n = mailbox[mailbox64[n] + dirForward];
-			if(n == -1) break;
-			if(board[n] == enemyPawn) {
-				return false; //enemy pawn in front, can not be passed
-			}
-		}
-		if(file != 0) { //pawn not on leftmost file, can check file to the left for enemy pawns
-			for (int n = square-1;;) {
-				n = mailbox[mailbox64[n] + dirForward];
-				if(n == -1) break;
-				if(board[n] == enemyPawn) {
-					return false; //enemy pawn in front, can not be passed
-				}
-			}
-		}
-		if(file != 7) { //pawn not on rightmost file, can check file to the right for enemy pawns
-			for (int n = square+1;;) {
-				n = mailbox[mailbox64[n] + dirForward];
-				if(n == -1) break;
-				if(board[n] == enemyPawn) {
-					return false; //enemy pawn in front, can not be passed
-				}
-			}
-		}
-		return true; //no enemy pawns found in front
+		return (passedPawnMasks[side][square] & board.getPieces(1-side, pawn)) == emptyBitboard;
 	}
 
 	/*
@@ -305,16 +265,7 @@ namespace tchess
 	 * return 0.
 	 */
 	unsigned int doubledPawnEvaluation(unsigned int side, unsigned int square, const chessboard& board) {
-		unsigned int dPawnCount = 0;
-		int ownPawn = side==white ? 1 : -1;
-		int file = square % 8;
-		for(int i = 0; i < 8; ++i) { //iterate file
-			unsigned int squareInFile = 8 * i + file;
-			int piece = board[squareInFile];
-			if(piece == ownPawn) { //another one of our pawns found on this file
-				++dPawnCount;
-			}
-		}
+		unsigned int dPawnCount = popCount(board.getPieces(side, pawn) & fileBitboards[square % 8]);
 		return dPawnCount < 2 ? 0 : dPawnCount;
 	}
 
@@ -322,18 +273,7 @@ namespace tchess
 	 * Checks if the pawn is isolated, meaning it has no friendly pawns on the neighbouring squares.
 	 */
 	bool isIsolatedPawn(unsigned int side, unsigned int square, const chessboard& board) {
-		int ownPawn = side==white ? 1 : -1;
-		for(unsigned int i = 0; i < offsetAmount[queen]; ++i) { //can get all neightboard using the queens directions
-			for (int n = square;;) {
-				n = mailbox[mailbox64[n] + offsets[queen][i]];
-				if(n == -1) break;
-				if(board[n] == ownPawn) {
-					return false; //own pawn found in the neighbordhood, cant be isolated
-				}
-				break; //only go to distance 1
-			}
-		}
-		return true;
+		return (kingAttacks[square] & board.getPieces(side, pawn)) == emptyBitboard;
 	}
 
 	/*
@@ -342,8 +282,6 @@ namespace tchess
 	 * The higher the return value, the safer it is for the side.
 	 */
 	int kingSafetyEvaluation(unsigned int side, unsigned int square, const chessboard& board) {
-		int file = square % 8;
-		int rank = square / 8;
 		/*
 		 * determine quadrant of the king
 		 *  ----------------------
@@ -354,164 +292,142 @@ namespace tchess
 		 *  |         |          |
 		 *  ----------------------
 		 */
-		unsigned int fromFile, toFile, fromRank, toRank;
-		if(file < 4) {
-			fromFile = 0;
-			toFile = 3;
-			if(rank < 4) { //q1
-				fromRank = 0;
-				toRank = 3;
-			} else { //q3
-				fromRank = 4;
-				toRank = 7;
-			}
-		} else {
-			fromFile = 4;
-			toFile = 7;
-			if(rank < 4) { //q2
-				fromRank = 0;
-				toRank = 3;
-			} else { //q4
-				fromRank = 4;
-				toRank = 7;
-			}
+		const bitboard leftFiles = fileBitboards[0] | fileBitboards[1] | fileBitboards[2] | fileBitboards[3];
+		const bitboard upperRanks = rankBitboards[0] | rankBitboards[1] | rankBitboards[2] | rankBitboards[3];
+		bitboard quadrant = (square % 8 < 4) ? leftFiles : ~leftFiles;
+		quadrant &= (square / 8 < 4) ? upperRanks : ~upperRanks;
+		quadrant &= ~squareBitboard(square); //king does not count
+		//count pieces in the quadrant, queens count 3 times
+		bitboard friendly = board.getPieces(side) & quadrant;
+		bitboard enemy = board.getPieces(1-side) & quadrant;
+		int friendlyPieces = popCount(friendly) + 2 * popCount(friendly & board.getPieces(side, queen));
+		int enemyPieces = popCount(enemy) + 2 * popCount(enemy & board.getPieces(1-side, queen));
+		return 5 * (friendlyPieces - enemyPieces);
+	}
+
+	/*
+	 * A term of the evaluation with a middlegame and an endgame value. The two are blended by the game
+	 * phase only once, at the end of the evaluation.
+	 */
+	struct tapered_score {
+		int midgame;
+		int endgame;
+
+		inline void add(int mg, int eg) {
+			midgame += mg;
+			endgame += eg;
 		}
-		int friendlyPieces = 0, enemyPieces = 0;
-		//count pieces in the quadrant
-		for(unsigned int i=fromRank; i<=toRank; ++i) {
-			for(unsigned int j=fromFile; j<=toFile; ++j) {
-				unsigned int checkedSquare = (i * 8) + j;
-				if(checkedSquare == square) continue; //king does not count
-				int piece = board[checkedSquare]; //piece (or empty) at this position
-				if(piece != 0) {
-					unsigned int sideOfPiece = piece > 0 ? white : black;
-					if(piece == 6 || piece == -6) { //this is a queen, counts as 3
-						sideOfPiece == side ? friendlyPieces+=3 : enemyPieces+=3;
-					} else { //not a queen, counts as 1
-						sideOfPiece == side ? ++friendlyPieces : ++enemyPieces;
-					}
-				}
 
+		inline void add(int value) {
+			midgame += value;
+			endgame += value;
+		}
+	};
+
+	/*
+	 * Evaluates the pawn structure: passed, isolated and doubled pawns. It only depends on the pawns,
+	 * so it is from white's point of view, and can be cached by the pawn hash key.
+	 */
+	static tapered_score evaluatePawnStructure(const chessboard& board) {
+		tapered_score evaluation = {0, 0};
+		for(unsigned int sideOfPiece = white; sideOfPiece <= black; ++sideOfPiece) {
+			tapered_score sideEvaluation = {0, 0};
+			bitboard pawns = board.getPieces(sideOfPiece, pawn);
+			while(pawns) {
+				unsigned int square = popLowestSquare(pawns);
+				if(isPassedPawn(sideOfPiece, square, board)) { //this pawn is passed, more important with less pieces
+					sideEvaluation.add(10, 20);
+				}
+				if(isIsolatedPawn(sideOfPiece, square, board)) { //check for isolation
+					sideEvaluation.add(-2);
+				}
+			}
+			//check for doubled pawns, each file is only counted once (any square of the file can be passed in)
+			for(unsigned int file = 0; file < 8; ++file) {
+				sideEvaluation.add(-8 * (int)doubledPawnEvaluation(sideOfPiece, file, board));
+			}
+			if(sideOfPiece == white) {
+				evaluation.add(sideEvaluation.midgame, sideEvaluation.endgame);
+			} else {
+				evaluation.add(-sideEvaluation.midgame, -sideEvaluation.endgame);
 			}
 		}
-		return 5 * (friendlyPieces - enemyPieces);
+		return evaluation;
 	}
 
-	int evaluateBoard(unsigned int side, const chessboard& board, const game_information& info, unsigned int movesAmount) {
+	int evaluateBoard(unsigned int side, const chessboard& board, const game_information& info, unsigned int movesAmount,
+			pawn_hash_table* pawnHashTable) {
 		//int sideMultiplier = side == white ? 1 : -1;
 		unsigned int enemySide = 1-side;
 
-		int pieceCounts[2][7] = { //stores how many of each piece we found
-				{0, 0, 0, 0, 0, 0, 0},
-				{0, 0, 0, 0, 0, 0, 0}
-		};
-
-		//Used to only count stacking "doubled" pawns on a file once.
-		bool doubledPawnCheckedFiles[8] = {false, false, false, false,false, false, false, false};
-
 		/*
 		 * No mates, sufficient material, can begin material/mobility evaluation.
 		 * The higher the score, the better this position is for the side to move.
 		 */
-		bool endgame = isEndgame(board);
 		//detect if we are in check
 		bool inCheck = isAttacked(board, enemySide, board.getKingSquare(side));
 		//detect if enemy is inCheck
 		bool enemyInCheck = isAttacked(board, side, board.getKingSquare(enemySide));
 		//begin evaluation with material and positional evaluation
-		int evaluation = 0;
-		for(unsigned int square = 0; square < 64; ++square) {
-			int piece = board[square];
-			if(piece != 0) { //piece here
-				unsigned int pieceType = piece > 0 ? piece : -piece;
-				unsigned int sideOfPiece = piece > 0 ? white : black;
-				// Material evaluation
-				if(sideOfPiece == side) { //a friendly piece
-					evaluation += pieceValues[pieceType];
-				} else { //an enemy piece
-					evaluation -= pieceValues[pieceType];
-				}
-				// piece square table evaluation + other piece specific
-				if(pieceType == pawn) {
-					evaluation += pawnTable[sideOfPiece][square];
-					if(isPassedPawn(sideOfPiece, square, board)) { //this pawn is passed
-						if(sideOfPiece == side) { //our passed pawn
-							evaluation += endgame ? 20 : 10;
-						} else { //enemy passed pawn
-							evaluation -= endgame ? 20 : 10;
-						}
-					}
-					//check for doubled pawns, if not found doubled pawns on this file already
-					if(!doubledPawnCheckedFiles[square%8]) {
-						unsigned int dp = doubledPawnEvaluation(sideOfPiece, square, board);
-						if(sideOfPiece == side) { //our doubled pawns
-							evaluation -= dp * 8;
-						} else { //enemy doubled pawns
-							evaluation += dp * 8;
-						}
-						doubledPawnCheckedFiles[square%8] = true; //so we wont check this file again
-					}
-					if(isIsolatedPawn(sideOfPiece, square, board)) { //check for isolation
-						if(sideOfPiece == side) { //our isolated pawn
-							evaluation -= 2;
-						} else { //enemy isolated pawn
-							evaluation += 2;
-						}
-					}
-
-				} else if(pieceType == knight) {
-					evaluation += knightTable[sideOfPiece][square];
-				} else if(pieceType == bishop) {
-					evaluation += bishopTable[sideOfPiece][square];
-					int pawnsAround = bishopLockedFactor(square, board);
-					if(sideOfPiece == side) { //our bishop
-						evaluation -= (10*pawnsAround); //not good if pawns are around bishop
-					} else { //enemy bishop
-						evaluation += (10*pawnsAround); //good if pawns are around enemy bishop
-					}
-				} else if(pieceType == rook) {
-					evaluation += rookTable[sideOfPiece][square];
-					int rfe = rookFileEvaluation(sideOfPiece, square, board);
-					if(sideOfPiece == side) { //evaluate rook file openness
-						evaluation += rfe;
-					} else {
-						evaluation -= rfe;
-					}
-				} else if(pieceType == king) {
-					if(endgame) {
-						evaluation += kingEndgameTable[sideOfPiece][square];
-					} else {
-						evaluation += kingTable[sideOfPiece][square];
-					}
-					int kingSafety = kingSafetyEvaluation(sideOfPiece, square, board);
-					if(sideOfPiece == side) { //our king
-						 evaluation += inCheck ? kingSafety - 20 : kingSafety;
-					} else { //enemy king
-						evaluation -= enemyInCheck ? kingSafety + 20 : kingSafety;
-					}
-				} else { //must be queen
-					evaluation += queenTable[sideOfPiece][square];
-				}
+		tapered_score evaluation = {0, 0};
+		for(unsigned int sideOfPiece = white; sideOfPiece <= black; ++sideOfPiece) {
+			//evaluation is calculated from the sides point of view, enemy terms are subtracted
+			//material and piece square tables: the board keeps their totals
+			tapered_score sideEvaluation = {board.getMidgameScore(sideOfPiece), board.getEndgameScore(sideOfPiece)};
+			// other piece specific terms, the pawn structure is evaluated for both sides below
+			bitboard bishops = board.getPieces(sideOfPiece, bishop);
+			if(popCount(bishops) >= 2) { //reward for bishop pair
+				sideEvaluation.add(15);
+			}
+			while(bishops) {
+				sideEvaluation.add(-10 * bishopLockedFactor(popLowestSquare(bishops), board)); //not good if pawns are around bishop
+			}
+			bitboard rooks = board.getPieces(sideOfPiece, rook);
+			while(rooks) {
+				unsigned int square = popLowestSquare(rooks);
+				sideEvaluation.add(rookFileEvaluation(sideOfPiece, square, board)); //evaluate rook file openness
+			}
+			//king safety only matters while there are pieces to attack the king, in the endgame the king should be active
+			sideEvaluation.add(kingSafetyEvaluation(sideOfPiece, board.getKingSquare(sideOfPiece), board), 0);
+			if(sideOfPiece == side) { //our pieces
+				if(inCheck) sideEvaluation.add(-20);
+				evaluation.add(sideEvaluation.midgame, sideEvaluation.endgame);
+			} else { //enemy pieces
+				if(enemyInCheck) sideEvaluation.add(20);
+				evaluation.add(-sideEvaluation.midgame, -sideEvaluation.endgame);
 			}
 		}
-		if(pieceCounts[side][bishop] >= 2) { //reward for bishop pair
-			evaluation += 15;
+		//pawn structure, from the pawn hash table if it was evaluated already
+		tapered_score pawnStructure;
+		if(pawnHashTable != nullptr) {
+			pawn_hash_entry& entry = pawnHashTable->entry(board.getPawnHashKey());
+			if(entry.key != board.getPawnHashKey()) {
+				pawnStructure = evaluatePawnStructure(board);
+				entry = {board.getPawnHashKey(), pawnStructure.midgame, pawnStructure.endgame};
+			} else {
+				pawnStructure = {entry.midgame, entry.endgame};
+			}
+		} else {
+			pawnStructure = evaluatePawnStructure(board);
 		}
-		if(pieceCounts[enemySide][bishop] >= 2) { //penalty for enemy bishop pair
-			evaluation -= 15;
+		if(side == white) {
+			evaluation.add(pawnStructure.midgame, pawnStructure.endgame);
+		} else {
+			evaluation.add(-pawnStructure.midgame, -pawnStructure.endgame);
 		}
 		//penalize side that has no castled in the early game
-		if(!endgame && !info.getHasCastled(side)) {
-			evaluation -= (info.getKingsideCastleRights(side)||info.getQueensideCastleRights(side)) ? 15 : 25;
+		if(!info.getHasCastled(side)) {
+			evaluation.add((info.getKingsideCastleRights(side)||info.getQueensideCastleRights(side)) ? -15 : -25, 0);
 		}
-		if(!endgame && !info.getHasCastled(enemySide)) {
-			evaluation += (info.getKingsideCastleRights(enemySide)||info.getQueensideCastleRights(enemySide)) ? 15 : 25;
+		if(!info.getHasCastled(enemySide)) {
+			evaluation.add((info.getKingsideCastleRights(enemySide)||info.getQueensideCastleRights(enemySide)) ? 15 : 25, 0);
 		}
 		//Mobility: warning: one sided
 		if(!inCheck) { //if we are not in check then almost all pseudo legal moves will be legal
-			evaluation += 2 * movesAmount;
+			evaluation.add(2 * movesAmount);
 		}
-		return evaluation;
+		//blend by the phase, promotions can make it more than the maximum
+		int phase = (int)std::min(board.getPhase(), maxGamePhase);
+		return (evaluation.midgame * phase + evaluation.endgame * ((int)maxGamePhase - phase)) / (int)maxGamePhase;
 	}
 }
-
@@ -9,6 +9,7 @@
 #define SRC_BOARD_EVALUATION_H_
 
 #include "board.h"
+#include "pawn_hash_table.h"
 
 namespace tchess
 {
@@ -52,12 +53,6 @@ namespace tchess
 	 */
 	special_board isSpecialBoard(unsigned int enemySide, const chessboard& board, bool legalMoves, int depth);
 
-	/*
-	 * Returns true if the board is in the endgame.
-	 * Definition: it is endgame if both sides have at most 13 worth of material (king not counted).
-	 */
-	bool isEndgame(const chessboard& board);
-
 	/*
 	 * Will count from how many diagonals a bishop is locked in BY PAWNS. The less the better
 	 */
@@ -96,6 +91,8 @@ namespace tchess
 
 	/*
 	 * Main static evaluator function. Used in negamax, so it evaluates relative to the side to move.
+	 * Each term has a middlegame and an endgame value, and the two sums are blended by the game phase
+	 * of the board, so the score changes smoothly as the pieces are traded.
 	 *
 	 * This method must be called after the move has been made on the board,
 	 * then after evaluation the move can be unmade.
@@ -105,9 +102,10 @@ namespace tchess
 	 *  - board: the board object
 	 *  - info: game info object needed to generate the enemy moves (to check for mates)
 	 *  - The amount of PSEUDO LEGAL moves this side has.
+	 *  - pawnHashTable: cache of the pawn structure evaluations, can be null, then the pawn structure is always evaluated.
 	 */
 	int evaluateBoard(unsigned int side, const chessboard& board,
-			const game_information& info, unsigned int moveAmount);
+			const game_information& info, unsigned int moveAmount, pawn_hash_table* pawnHashTable = nullptr);
 }
 
 #endif /* SRC_BOARD_EVALUATION_H_ */
@@ -4,7 +4,6 @@
 
 #include "move.h"
 #include "board.h"
-#include "../game/game.h"
 
 /*
  * move.cpp
@@ -17,50 +16,6 @@
 
 namespace tchess
 {
-	const unsigned int resignMove = 6;
-
-	//Move code for a "non-special" move that results in no capture.
-	extern const unsigned int quietMove = 0;
-
-	//Move code for double pawn pushes.
-	extern const unsigned int doublePawnPush = 1;
-
-	//Move code for kingside castle.
-	extern const unsigned int kingsideCastle = 2;
-
-	//Move code for queenside castle.
-	extern const unsigned int queensideCastle = 3;
-
-	//Move code for captures.
-	extern const unsigned int capture = 4;
-
-	//Move code for en-passant captures.
-	extern const unsigned int enPassantCapture = 5;
-
-	//Move code for a pawn push that results in a knight promotion.
-	extern const unsigned int knightPromotion = 8;
-
-	//Move code for a pawn push that results in a bishop promotion.
-	extern const unsigned int bishopPromotion = 9;
-
-	//Move code for a pawn push that results in a rook promotion.
-	extern const unsigned int rookPromotion = 10;
-
-	//Move code for a pawn push that results in a queen promotion.
-	extern const unsigned int queenPromotion = 11;
-
-	//Move code for a pawn push that captures and results in a knight promotion.
-	extern const unsigned int knightPromotionCap = 12;
-
-	//Move code for a pawn push that captures and results in a bishop promotion.
-	extern const unsigned int bishopPromotionCap = 13;
-
-	//Move code for a pawn push that captures and results in a rook promotion.
-	extern const unsigned int rookPromotionCap = 14;
-
-	//Move code for a pawn push that captures and results in a queen promotion.
-	extern const unsigned int queenPromotionCap = 15;
-
 	/*
 	 * Meaning of a row: capturing piece.
 	 * Meaining of a column: captured piece.
@@ -84,39 +39,16 @@ namespace tchess
 
 	unsigned int move::promotedTo() const {
 		//assumes this a promotion, so only checking special bits
-		int s1 = flags[1], s2 = flags[0];
-		if(s1==1 && s2==1) return queen;
-		if(s1==1 && s2==0) return rook;
-		if(s1==0 && s2==1) return bishop;
-		return knight;
-	}
-
-	bool move::operator==(const move& other) const {
-		if(isPromotion()) {
-			return fromSquare == other.fromSquare && toSquare == other.toSquare &&
-					promotedTo() == other.promotedTo();
-		} else { //the kings dep. and dest. squares are enough to check castle equality as well
-			bool squaresEqual = fromSquare == other.fromSquare && toSquare == other.toSquare;
-			bool flagsEqual = true;
-			for(int i=0; i<4; ++i) {
-				if(flags[i] != other.flags[i]) flagsEqual = false;
-			}
-			return squaresEqual && flagsEqual;
-		}
-	}
-
-	 bool move::operator>(const move& m) const {
-		 return score > m.score;
-	 }
-
-	move& move::operator=(const move& other) {
-		fromSquare = other.fromSquare;
-		toSquare = other.toSquare;
-		score = other.score;
-		for(int i=0; i<4; ++i) {
-			flags[i] = other.flags[i];
+		switch(getFlags() & 3) {
+		case 3:
+			return queen;
+		case 2:
+			return rook;
+		case 1:
+			return bishop;
+		default:
+			return knight;
 		}
-		return *this;
 	}
 
 	//Helper method to convert piece codes into letters
@@ -157,13 +89,13 @@ namespace tchess
 		std::string moveString;
 		moveString += pieceNameFromCode(pieceThatMoved);
 		moveString += " ";
-		moveString += createSquareName(fromSquare);
+		moveString += createSquareName(getFromSquare());
 		if(isCapture()) { //write x if capture
 			moveString += " x ";
 		} else {
 			moveString += " ";
 		}
-		moveString += createSquareName(toSquare);
+		moveString += createSquareName(getToSquare());
 		if(isPromotion()) { //write what it was promoted to if it was promotion
 			moveString += " = ";
 			int prom = promotedTo();
@@ -190,7 +122,7 @@ namespace tchess
 		}
 	}
 
-	const move NULLMOVE = move(0, 0, quietMove, 0);
+	const move NULLMOVE = move(0, 0, quietMove);
 
 	//move string will come in the form of: piece_code from_square to_square 
 	move parse_move(char pieceCode, unsigned int fromSquare, unsigned int toSquare, unsigned int side, char promotionCode) {
@@ -203,10 +135,10 @@ namespace tchess
 		unsigned int qsCastleTo = side == white ? 58 : 2;
 		if(pieceCode == 'K' && fromSquare == ksCastleFrom && toSquare == ksCastleTo) {
 			//this is a kingside castle
-			return move(fromSquare, toSquare, kingsideCastle, 0);
+			return move(fromSquare, toSquare, kingsideCastle);
 		} else if(pieceCode == 'K' && fromSquare == qsCastleFrom && toSquare == qsCastleTo) {
 			//this is a queenside castle
-			return move(fromSquare, toSquare, queensideCastle, 0);
+			return move(fromSquare, toSquare, queensideCastle);
 		}
 		//if the move is a promotion
 		if (pieceCode == 'P' && checkForPromotion(createSquareName(fromSquare), createSquareName(toSquare), side)) {
@@ -231,7 +163,7 @@ namespace tchess
 				throw move_parse_exception("Unrecognized promotion piece code!");
 			}
 			//move is a promotion, with a valid promotion piece code
-			return move(fromSquare, toSquare, promMoveType, 0);
+			return move(fromSquare, toSquare, promMoveType);
 		}
 		else { //this move does not appear to be a promotion
 			unsigned int moveType = quietMove;
@@ -244,7 +176,7 @@ namespace tchess
 			 * but we have no way of knowing that here, so just using quiet move type.
 			 * It will be fixed in the 'captureFix' method of game controller
 			 */
-			return move(fromSquare, toSquare, moveType, 0);
+			return move(fromSquare, toSquare, moveType);
 		}
 	}
 
@@ -269,13 +201,13 @@ namespace tchess
 			//get kingside castle squares for KING, depending on side
 			fromSquare = side == white ? 60 : 4;
 			toSquare = side == white ? 62 : 6;
-			return move(fromSquare, toSquare, kingsideCastle, 0);
+			return move(fromSquare, toSquare, kingsideCastle);
 		}
 		else if (moveString == "o-o-o") {
 			//get queenside castle squares for KING, depending on side
 			fromSquare = side == white ? 60 : 4;
 			toSquare = side == white ? 58 : 2;
-			return move(fromSquare, toSquare, queensideCastle, 0);
+			return move(fromSquare, toSquare, queensideCastle);
 		}
 		//move is not castle, so there must be piece code, departure and destination squares specified
 		std::vector<std::string> splitMove = split(moveString, ' ');
@@ -316,7 +248,7 @@ namespace tchess
 					throw move_parse_exception("Unrecognized promotion piece code!");
 				}
 				//move is a promotion, with a valid promotion piece code
-				return move(fromSquare, toSquare, promMoveType, 0);
+				return move(fromSquare, toSquare, promMoveType);
 			}
 			else { //this move does not appear to be a promotion
 				unsigned int moveType = quietMove;
@@ -331,7 +263,7 @@ namespace tchess
 				 * This move may be a capture
 				 * but we have no way of knowing that here, so just using quiet move type.
 				 */
-				return move(fromSquare, toSquare, moveType, 0);
+				return move(fromSquare, toSquare, moveType);
 			}
 		}
 		catch (std::runtime_error&) { //failed to parse square names
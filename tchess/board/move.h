@@ -13,55 +13,54 @@
 #define NO_PROMOTION 'a'
 
 #include <string>
-#include <bitset>
 #include <stdexcept>
 
 namespace tchess
 {
 	//Special move that indicated that player resigned.
-	extern const unsigned int resignMove;
+	const unsigned int resignMove = 6;
 
 	//Move code for a "non-special" move that results in no capture.
-	extern const unsigned int quietMove;
+	const unsigned int quietMove = 0;
 
 	//Move code for double pawn pushes.
-	extern const unsigned int doublePawnPush;
+	const unsigned int doublePawnPush = 1;
 
 	//Move code for kingside castle.
-	extern const unsigned int kingsideCastle;
+	const unsigned int kingsideCastle = 2;
 
 	//Move code for queenside castle.
-	extern const unsigned int queensideCastle;
+	const unsigned int queensideCastle = 3;
 
 	//Move code for captures.
-	extern const unsigned int capture;
+	const unsigned int capture = 4;
 
 	//Move code for en-passant captures.
-	extern const unsigned int enPassantCapture;
+	const unsigned int enPassantCapture = 5;
 
 	//Move code for a pawn push that results in a knight promotion.
-	extern const unsigned int knightPromotion;
+	const unsigned int knightPromotion = 8;
 
 	//Move code for a pawn push that results in a bishop promotion.
-	extern const unsigned int bishopPromotion;
+	const unsigned int bishopPromotion = 9;
 
 	//Move code for a pawn push that results in a rook promotion.
-	extern const unsigned int rookPromotion;
+	const unsigned int rookPromotion = 10;
 
 	//Move code for a pawn push that results in a queen promotion.
-	extern const unsigned int queenPromotion;
+	const unsigned int queenPromotion = 11;
 
 	//Move code for a pawn push that captures and results in a knight promotion.
-	extern const unsigned int knightPromotionCap;
+	const unsigned int knightPromotionCap = 12;
 
 	//Move code for a pawn push that captures and results in a bishop promotion.
-	extern const unsigned int bishopPromotionCap;
+	const unsigned int bishopPromotionCap = 13;
 
 	//Move code for a pawn push that captures and results in a rook promotion.
-	extern const unsigned int rookPromotionCap;
+	const unsigned int rookPromotionCap = 14;
 
 	//Move code for a pawn push that captures and results in a queen promotion.
-	extern const unsigned int queenPromotionCap;
+	const unsigned int queenPromotionCap = 15;
 
 	/*
 	 * This exception is thrown when a move string could not
@@ -123,97 +122,69 @@ namespace tchess
 
 	/**
 	 * Represents a chess move, using the departure square (from) and the destination
-	 * square (to).
+	 * square (to), packed into 16 bits:
+	 *  - bits 0-5: departure square
+	 *  - bits 6-11: destination square
+	 *  - bits 12-15: the 4 flags
 	 *
-	 * Also includes 4 flags in a bitfield. These flags are:
-	 *  - Bit 1: capture flag
-	 *  - Bit 2: promotion flag
-	 *  - Bit 3: Special flag 1
-	 *  - Bit 4: Special flag 2
+	 * The flags (from the lowest bit) are:
+	 *  - Special flag 2
+	 *  - Special flag 1
+	 *  - capture flag
+	 *  - promotion flag
 	 *
-	 * The possible bitfields are declared as constants in this file. For example, bishop promotion capture
+	 * The possible flag codes are declared as constants in this file. For example, bishop promotion capture
 	 * is 13 (binary 1101), so both capture and promotion flags are 1, but only the second special flag is 1.
 	 *
 	 * For castling the departure and destination squares of the move will be the departure and destination
 	 * of the king.
+	 *
+	 * The move is trivially copyable. Its score for the move ordering is not part of it, the move lists store that.
 	 */
 	class move {
 
-		//Departure square of the move.
-		unsigned int fromSquare;
-
-		//Destination square of the move.
-		unsigned int toSquare;
-
-		//The 4 bit wide bitfield containing the flags.
-		std::bitset<4> flags;
-
-		/*
-		 * The score of the move determines how high it will go in the move ordering. Player
-		 * agents that do not care about move ordering can set this to 0.
-		 * During move generation each generated move will get a score depending on the MvvLva scheme
-		 * (most valuable victim, least valuable attacker).
-		 */
-		unsigned int score;
+		unsigned short data;
 
 	public:
-		move() : fromSquare(0), toSquare(0), score(0) {} //<- basically NULLMOVE
+		move() : data(0) {} //<- basically NULLMOVE
 
 		//Create a move object
-		move(unsigned int fromSquare, unsigned int toSquare, unsigned int flags, unsigned int score) :
-			fromSquare(fromSquare), toSquare(toSquare), flags(flags), score(score) {}
-
-		move(const move& other) : fromSquare(other.fromSquare), toSquare(other.toSquare),
-				flags(0), score(other.score) {
-			for(int i=0; i<4; ++i) {
-				flags[i] = other.flags[i];
-			}
-		}
-
-		/*
-		 * Assignment operator.
-		 */
-		move& operator=(const move& other);
+		move(unsigned int fromSquare, unsigned int toSquare, unsigned int flags) :
+			data((unsigned short)(fromSquare | (toSquare << 6) | (flags << 12))) {}
 
 		//Checks if this move is the special resign move.
 		inline bool isResign() const {
-			return !flags[0] && flags[1] && flags[2] && !flags[3];
+			return getFlags() == resignMove;
 		}
 
 		//Checks if this move is a capture.
 		inline bool isCapture() const {
-			//need to check the second bit (bitset goes backwards...)
-			return flags[2];
+			return (data & 0x4000) != 0;
 		}
 
 		//Checks if this move is a promotion.
 		inline bool isPromotion() const {
-			//need to check first bit  (bitset goes backwards...)
-			return flags[3];
+			return (data & 0x8000) != 0;
 		}
 
 		//Checks if this move is a double pawn push.
 		inline bool isDoublePawnPush() const {
-			//not capture, promotion and only second special bit is on  (bitset goes backwards...)
-			return !flags[3] && !flags[2] && !flags[1] && flags[0];
+			return getFlags() == doublePawnPush;
 		}
 
 		//Checks if this move is a kingside castle.
 		inline bool isKingsideCastle() const {
-			//not capture, promotion and only the first special bit is true
-			return !flags[3] && !flags[2] && flags[1] && !flags[0];
+			return getFlags() == kingsideCastle;
 		}
 
 		//Checks if this move is a queenside castle.
 		inline bool isQueensideCastle() const {
-			//not capture, promotion and both special bits are true
-			return !flags[3] && !flags[2] && flags[1] && flags[0];
+			return getFlags() == queensideCastle;
 		}
 
 		//Checks if this move is an en-passant capture.
 		inline bool isEnPassant() const {
-			//is a capture but not a promotion and only second special bit is true
-			return !flags[3] && flags[2] && !flags[1] && flags[0];
+			return getFlags() == enPassantCapture;
 		}
 
 		/*
@@ -225,23 +196,30 @@ namespace tchess
 		 */
 		unsigned int promotedTo() const;
 
-		inline unsigned int getFromSquare() const { return fromSquare; }
+		inline unsigned int getFromSquare() const { return data & 0x3F; }
 
-		inline unsigned int getToSquare() const { return toSquare; }
+		inline unsigned int getToSquare() const { return (data >> 6) & 0x3F; }
 
-		inline unsigned int getScore() const { return score; }
+		//The 4 bit flag code of the move (see the constants above).
+		inline unsigned int getFlags() const { return data >> 12; }
 
-		/*
-		 * Equality check between 2 moves. They are equal if both the departure
-		 * and the destination squares are equal. In case of promotions, the equality
-		 * of the promoted piece is also checked.
-		 */
-		bool operator==(const move& other) const;
+		//The move in its 16 bit form, for example to store it in the transposition table.
+		inline unsigned short getData() const { return data; }
+
+		//Creates a move from its 16 bit form.
+		static inline move fromData(unsigned short data) {
+			move m;
+			m.data = data;
+			return m;
+		}
 
 		/*
-		 * Used to sort move vectors into descending order.
+		 * Equality check between 2 moves. They are equal if the departure and destination squares and the
+		 * flags are all equal.
 		 */
-		 bool operator>(const move& m) const;
+		inline bool operator==(const move& other) const {
+			return data == other.data;
+		}
 
 		/*
 		 * Creates a string format of the move. Since the move
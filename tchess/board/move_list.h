@@ -0,0 +1,105 @@
+/*
+ * move_list.h
+ *
+ * Fixed capacity move list, so that move generation during the search doesn't allocate.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_BOARD_MOVE_LIST_H_
+#define SRC_BOARD_MOVE_LIST_H_
+
+#include "move.h"
+
+namespace tchess
+{
+	/*
+	 * Capacity of a move list. No position has more than 218 legal moves, and the pseudo legal
+	 * moves don't go far beyond that either.
+	 */
+	const unsigned int maxMoves = 256;
+
+	/*
+	 * List of moves in a fixed size array, meant to live on the stack. It has the parts of the
+	 * vector interface that the move generation and the search use. Each move has a score for the
+	 * move ordering next to it, the move generator gives MVV-LVA scores to the captures.
+	 */
+	class move_list {
+
+		move moves[maxMoves];
+
+		unsigned int scores[maxMoves];
+
+		unsigned int count;
+
+	public:
+		move_list() : count(0) {}
+
+		inline void push_back(const move& m, unsigned int score = 0) {
+			moves[count] = m;
+			scores[count++] = score;
+		}
+
+		inline unsigned int getScore(unsigned int index) const {
+			return scores[index];
+		}
+
+		inline void setScore(unsigned int index, unsigned int score) {
+			scores[index] = score;
+		}
+
+		//Swaps two moves with their scores.
+		inline void swap(unsigned int i, unsigned int j) {
+			move m = moves[i];
+			moves[i] = moves[j];
+			moves[j] = m;
+			unsigned int s = scores[i];
+			scores[i] = scores[j];
+			scores[j] = s;
+		}
+
+		inline void clear() {
+			count = 0;
+		}
+
+		//Keeps only the first moves of the list, the size must not be larger than the current one.
+		inline void truncate(unsigned int size) {
+			count = size;
+		}
+
+		inline unsigned int size() const {
+			return count;
+		}
+
+		inline bool empty() const {
+			return count == 0;
+		}
+
+		inline move& operator[](unsigned int index) {
+			return moves[index];
+		}
+
+		inline const move& operator[](unsigned int index) const {
+			return moves[index];
+		}
+
+		inline move* begin() {
+			return moves;
+		}
+
+		inline move* end() {
+			return moves + count;
+		}
+
+		inline const move* begin() const {
+			return moves;
+		}
+
+		inline const move* end() const {
+			return moves + count;
+		}
+	};
+}
+
+#endif /* SRC_BOARD_MOVE_LIST_H_ */
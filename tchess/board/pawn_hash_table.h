@@ -0,0 +1,56 @@
+/*
+ * pawn_hash_table.h
+ *
+ * Cache of the pawn structure terms of the evaluation. The pawns of a position change rarely in a subtree of
+ * the search, so most evaluations find their pawn structure here, with the pawn hash key of the board.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_BOARD_PAWN_HASH_TABLE_H_
+#define SRC_BOARD_PAWN_HASH_TABLE_H_
+
+#include <vector>
+
+#include "zobrist.h"
+
+namespace tchess
+{
+	//Amount of entries in the pawn hash table, must be a power of 2. 16 bytes each.
+	const unsigned int pawnHashTableSize = 1 << 14;
+
+	/*
+	 * Pawn structure evaluation (passed, isolated and doubled pawns) of a position, from white's point
+	 * of view, separately for the middlegame and the endgame.
+	 */
+	struct pawn_hash_entry {
+
+		//Pawn hash key of the position.
+		uint64 key;
+
+		int midgame;
+
+		int endgame;
+	};
+
+	/*
+	 * Fixed size, always replace cache of the pawn evaluations. It is not thread safe, each search worker
+	 * has its own. The empty entries have key 0 and 0 evaluation, which is also the correct entry of a board
+	 * without pawns.
+	 */
+	class pawn_hash_table {
+
+		std::vector<pawn_hash_entry> entries;
+
+	public:
+		pawn_hash_table() : entries(pawnHashTableSize, pawn_hash_entry{0, 0, 0}) {}
+
+		//The entry of the key, it belongs to the key only if its key is the same.
+		inline pawn_hash_entry& entry(uint64 key) {
+			return entries[key & (pawnHashTableSize - 1)];
+		}
+	};
+}
+
+#endif /* SRC_BOARD_PAWN_HASH_TABLE_H_ */
@@ -0,0 +1,43 @@
+/*
+ * piece_square.h
+ *
+ * Material and piece square table values of each piece on each square, in the form that the chessboard
+ * uses to keep the totals of both sides up to date. Like the zobrist hash, the totals are updated with every
+ * change of the board, so the evaluation does not need to scan the board for them.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_BOARD_PIECE_SQUARE_H_
+#define SRC_BOARD_PIECE_SQUARE_H_
+
+namespace tchess
+{
+	/*
+	 * How much each piece counts in the game phase. Pawns and kings don't count, so the phase only
+	 * goes down as the pieces are traded.
+	 */
+	extern const unsigned int piecePhase[7];
+
+	/*
+	 * Game phase with all pieces on the board: the middlegame. Phase 0 is a pure endgame, and the evaluation
+	 * blends the middlegame and endgame scores by the phase in between. It can be more after promotions.
+	 */
+	const unsigned int maxGamePhase = 24;
+
+	/*
+	 * Value of a piece on a square in the middlegame: the piece value and the piece square table value
+	 * together. The first index is the side, the second is the (positive) piece code, the third is the mailbox
+	 * square. Filled at startup from the tables of evaluation.cpp.
+	 */
+	extern int midgamePieceSquareValues[2][7][64];
+
+	/*
+	 * Value of a piece on a square in the endgame, same as the middlegame value except for
+	 * the king, which uses the endgame king table. Filled at startup.
+	 */
+	extern int endgamePieceSquareValues[2][7][64];
+}
+
+#endif /* SRC_BOARD_PIECE_SQUARE_H_ */
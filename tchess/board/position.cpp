@@ -0,0 +1,63 @@
+/*
+ * position.cpp
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#include <stdexcept>
+
+#include "position.h"
+
+namespace tchess
+{
+	void position::set(const chessboard& b, const game_information& i) {
+		board = b;
+		info = i;
+		historySize = 0;
+	}
+
+	undo_state& position::pushState(const move& m) {
+		if(historySize == maxPositionHistory) {
+			throw std::runtime_error("Too many moves made on the position!");
+		}
+		undo_state& state = history[historySize++];
+		state.infoHashKey = info.getHashKey();
+		state.enPassantSquare = (int)info.getEnPassantSquare(info.getSideToMove());
+		state.halfmoveClock = info.getHalfmoveClock();
+		state.lastMove = m;
+		state.castleRights = (unsigned char)info.getCastleRights();
+		return state;
+	}
+
+	void position::makeMove(const move& m) {
+		undo_state& state = pushState(m);
+		state.capturedPiece = board.makeMove(m, info.getSideToMove());
+		updateGameInformation(board, m, info);
+	}
+
+	void position::unmakeMove() {
+		const undo_state& state = history[--historySize];
+		const unsigned int side = 1 - info.getSideToMove(); //the side that made the move
+		if(state.lastMove.isKingsideCastle() || state.lastMove.isQueensideCastle()) {
+			info.clearHasCastled(side); //a side castles only once, so it had not castled before
+		}
+		if(side == black) info.setFullmoveNumber(info.getFullmoveNumber() - 1);
+		info.restore(side, state.castleRights, state.enPassantSquare, state.infoHashKey, state.halfmoveClock);
+		board.unmakeMove(state.lastMove, side, state.capturedPiece);
+	}
+
+	void position::makeNullMove() {
+		undo_state& state = pushState(NULLMOVE);
+		state.capturedPiece = empty;
+		unsigned int side = info.getSideToMove();
+		info.setEnPassantSquare(side, noEnPassant);
+		info.setHalfmoveClock(info.getHalfmoveClock() + 1);
+		info.setSideToMove(1 - side);
+	}
+
+	void position::unmakeNullMove() {
+		const undo_state& state = history[--historySize];
+		info.restore(1 - info.getSideToMove(), state.castleRights, state.enPassantSquare, state.infoHashKey, state.halfmoveClock);
+	}
+}
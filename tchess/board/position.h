@@ -0,0 +1,119 @@
+/*
+ * position.h
+ *
+ * A chessboard and its game information together, with an undo stack, so that the
+ * search can make and unmake moves on one object instead of copying the game information for each node.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_BOARD_POSITION_H_
+#define SRC_BOARD_POSITION_H_
+
+#include "board.h"
+
+namespace tchess
+{
+	//Maximum amount of moves that can be made on a position without unmaking them.
+	const unsigned int maxPositionHistory = 256;
+
+	/*
+	 * What a move changed on the position and can't be computed back from the move. The side to move, the
+	 * castled flag and the fullmove number of the game information are computed back, the rest is stored here.
+	 */
+	struct undo_state {
+
+		//Hash key of the game information before the move.
+		uint64 infoHashKey;
+
+		//Code of the captured piece, empty if there was no capture.
+		int capturedPiece;
+
+		//En passant square of the side that moved, the other side had none.
+		int enPassantSquare;
+
+		//Halfmove clock before the move.
+		unsigned int halfmoveClock;
+
+		//The move that was made, NULLMOVE for a null move.
+		move lastMove;
+
+		//Castle rights before the move, see game_information::getCastleRights.
+		unsigned char castleRights;
+	};
+
+	/*
+	 * Board and game information, with a stack of the states that unmakeMove restores. Making and unmaking a move is
+	 * constant time: the game information is updated only from the move squares, and restored from the few fields
+	 * of the stack.
+	 */
+	class position {
+
+		chessboard board;
+
+		game_information info;
+
+		undo_state history[maxPositionHistory];
+
+		//Amount of moves made that were not unmade yet.
+		unsigned int historySize;
+
+	public:
+		//The starting position.
+		position() : historySize(0) {}
+
+		position(const chessboard& board, const game_information& info) : board(board), info(info), historySize(0) {}
+
+		//Sets a new position, and clears the undo stack.
+		void set(const chessboard& board, const game_information& info);
+
+		//Makes a (pseudo legal) move for the side to move.
+		void makeMove(const move& m);
+
+		//Unmakes the last move made with makeMove.
+		void unmakeMove();
+
+		/*
+		 * Passes the move to the other side: only the side to move and the en passant square
+		 * changes. Used by null move pruning.
+		 */
+		void makeNullMove();
+
+		//Unmakes the last null move.
+		void unmakeNullMove();
+
+		//Checks if a move is legal for the side to move, it may come from anywhere.
+		inline bool isLegal(const move& m) const {
+			return move_generator(board, info).isLegalMove(info.getSideToMove(), m);
+		}
+
+		inline const chessboard& getBoard() const {
+			return board;
+		}
+
+		inline const game_information& getInfo() const {
+			return info;
+		}
+
+		inline unsigned int getSideToMove() const {
+			return info.getSideToMove();
+		}
+
+		//Zobrist hash of the position.
+		inline uint64 getHashKey() const {
+			return positionHashKey(board, info);
+		}
+
+		//The last move made that was not unmade yet, NULLMOVE if there is none or it was a null move.
+		inline const move& getLastMove() const {
+			return historySize > 0 ? history[historySize - 1].lastMove : NULLMOVE;
+		}
+
+	private:
+		//Puts the state before the move on the undo stack, the captured piece is set by the caller.
+		undo_state& pushState(const move& m);
+	};
+}
+
+#endif /* SRC_BOARD_POSITION_H_ */
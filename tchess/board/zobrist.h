@@ -0,0 +1,54 @@
+/*
+ * zobrist.h
+ *
+ * Random numbers for hashing positions. The numbers are the ones used by polyglot opening books, and
+ * the transposition table also uses them. The hash of a position is the XOR of the numbers that belong
+ * to its pieces, castling rights, en passant file and side to move. These parts can be updated one by one
+ * when a move is made: the chessboard maintains the piece part, the game_information maintains the rest.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_BOARD_ZOBRIST_H_
+#define SRC_BOARD_ZOBRIST_H_
+
+#ifdef _MSC_VER
+#  define U64(u) (u##ui64)
+#else
+#  define U64(u) (u##ULL)
+#endif
+
+//Unsigned 64 bit integer type definition.
+typedef unsigned long long uint64;
+
+namespace tchess
+{
+	//Random array used by polyglot books AND the transposition table.
+	extern const uint64 Random64[781];
+
+	/*
+	 * Offset of the castling keys in the random array. Order is white kingside, white queenside,
+	 * black kingside, black queenside.
+	 */
+	const unsigned int castleKeyOffset = 768;
+
+	//Offset of the en passant file keys in the random array, there is one for each file.
+	const unsigned int enPassantKeyOffset = 772;
+
+	//Offset of the side to move key in the random array.
+	const unsigned int sideKeyOffset = 780;
+
+	/*
+	 * The random numbers of the pieces reordered for fast lookup: the first index is the side, the second
+	 * is the (positive) piece code, the third is the mailbox square. Filled at startup.
+	 */
+	extern uint64 zobristPieceKeys[2][7][64];
+
+	//Hash key of a piece on a square, the piece code is negative for black pieces.
+	inline uint64 zobristPieceKey(int piece, unsigned int square) {
+		return piece > 0 ? zobristPieceKeys[0][piece][square] : zobristPieceKeys[1][-piece][square];
+	}
+}
+
+#endif /* SRC_BOARD_ZOBRIST_H_ */
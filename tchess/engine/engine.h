@@ -10,79 +10,68 @@
 #ifndef SRC_ENGINE_ENGINE_H_
 #define SRC_ENGINE_ENGINE_H_
 
-#define USE_OPENING_BOOK true
+#include <string>
 
 #include "game/player.h"
-#include "polyglot.h"
-#include "transposition_table.h"
-#include "move_ordering.h"
+#include "search_engine.h"
+#include "search_listener.h"
 
 namespace tchess
 {
 	/*
-	 * Tree search depth used by the engine.
+	 * Reports the search progress to the GUI with window messages, which set the range and
+	 * the position of the progress bar. The other events are printed to the console.
 	 */
-	extern unsigned int engine_depth;
+	class gui_search_listener: public search_listener {
 
-	/*
-	 * Player agent for the Tchess engine.
-	 */
-	class engine: public player {
+		//GUI that receives the messages.
+		TChessRootDialogView* view;
 
-		//Search depth.
-		unsigned int depth;
+	public:
+		gui_search_listener(TChessRootDialogView* view) : view(view) {}
 
-		//Board object.
-		chessboard board;
+		void rootMovesGenerated(unsigned int moveCount) override;
 
-		//game info object.
-		game_information info;
+		void rootMovesSearched(unsigned int searchedCount) override;
 
-		//Stores if the engine is playing opening mode (from book) or not.
-		bool opening;
+		void bookMoveFound() override;
 
-		//Polyglot opening book.
-		opening_book openingBook;
+		void searchStarted() override;
 
-		/*
-		 * The transposition table used by the engine.
-		 */
-		transposition_table* ttable;
+		void iterationCompleted(unsigned int depth, const move& bestMove, int pieceThatMoved, int score,
+				unsigned long long nodes, long long milliseconds) override;
+
+		void searchFinished(unsigned int threadCount, unsigned long long nodes, long long milliseconds,
+				unsigned int depth, const search_statistics& statistics) override;
+	};
+
+	/*
+	 * Player agent for the Tchess engine. The search itself is done by the search engine, this
+	 * only passes the moves of the game to it.
+	 */
+	class engine: public player {
+
+		//Forwards the search progress to the GUI.
+		gui_search_listener listener;
+
+		//Position, opening book and search of the engine.
+		search_engine searchEngine;
 
 	public:
 		engine() = delete;
 
-		engine(unsigned int side, TChessRootDialogView* view, unsigned int depth = engine_depth)
-			: player(side, false, view), depth(depth), opening(USE_OPENING_BOOK) {
-			ttable = new transposition_table(def_transposition_table_size);
-		}
-
-		~engine() {
-			delete ttable;
-		}
+		engine(unsigned int side, TChessRootDialogView* view, unsigned int depth = engine_depth,
+				unsigned int timeBudget = engine_time_budget, unsigned long long nodeBudget = engine_node_budget,
+				unsigned int threadCount = engine_threads, unsigned int hashSize = engine_hash_size)
+			: player(side, false, view), listener(view), searchEngine(&listener, depth, timeBudget, nodeBudget, threadCount, hashSize) {}
 
 		/*
 		 * Will submit the best move it can find after evaluating the
-		 * game tree down to a certain depth.
+		 * game tree as deep as the depth, time and node budgets allow.
 		 */
 		move makeMove(game* gameController) override;
 
 		std::string description() const override;
-
-	private:
-		/*
-		 * The root negamax function. Unlike the normal negamax, this
-		 * will return the best move instead of the best evaluation.
-		 */
-		move alphaBetaNegamaxRoot();
-
-		/*
-		 * Negamax tree searching method with alpha-beta cutoff.
-		 * - depth left: Current search depth. If this is 0, then we dont go deeper and evaluate.
-		 * - game info: the non-reversible elements of the board. These are copy made and passed in.
-		 * - pvLine: collected principal variation of the parent node.
-		 */
-		int alphaBetaNegamax(int alpha, int beta, unsigned int depthLeft, game_information& gameInfo);
 	};
 
 }
@@ -6,6 +6,7 @@
  */
 #include <stack>
 #include <iostream>
+#include <cstring>
 
 #include "move_ordering.h"
 
@@ -22,5 +23,47 @@ namespace tchess
 	void printPrincipalVariation(chessboard& board, const game_information& info, unsigned int depth) {
 
 	}
+
+	//When a history score goes above this, all scores are halved, so that they can't overflow.
+	static const unsigned int maxHistoryScore = 1 << 20;
+
+	move_ordering_tables::move_ordering_tables() {
+		std::memset(history, 0, sizeof(history));
+		//the move arrays are filled with NULLMOVE by the default constructor
+	}
+
+	void move_ordering_tables::ageTables() {
+		for(unsigned int ply = 0; ply < maxKillerPly; ++ply) {
+			killers[ply][0] = NULLMOVE;
+			killers[ply][1] = NULLMOVE;
+		}
+		for(unsigned int side = 0; side < 2; ++side) {
+			for(unsigned int from = 0; from < 64; ++from) {
+				for(unsigned int to = 0; to < 64; ++to) {
+					history[side][from][to] /= 2;
+				}
+			}
+		}
+	}
+
+	void move_ordering_tables::storeCutoff(unsigned int side, const move& m, unsigned int ply, unsigned int depthLeft,
+			const move& previousMove) {
+		if(ply < maxKillerPly && !(killers[ply][0] == m)) { //the newest killer goes first
+			killers[ply][1] = killers[ply][0];
+			killers[ply][0] = m;
+		}
+		unsigned int& score = history[side][m.getFromSquare()][m.getToSquare()];
+		score += depthLeft * depthLeft; //deep cutoffs are worth more
+		if(score > maxHistoryScore) {
+			for(unsigned int from = 0; from < 64; ++from) {
+				for(unsigned int to = 0; to < 64; ++to) {
+					history[side][from][to] /= 2;
+				}
+			}
+		}
+		if(!(previousMove == NULLMOVE)) {
+			counterMoves[side][previousMove.getFromSquare()][previousMove.getToSquare()] = m;
+		}
+	}
 }
 
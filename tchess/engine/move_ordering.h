@@ -17,6 +17,56 @@ namespace tchess
 	 */
 	void printPrincipalVariation(chessboard& board, const game_information& info, unsigned int depth);
 
+	//Killer moves are stored for this many plies from the root.
+	const unsigned int maxKillerPly = 128;
+
+	/*
+	 * Tables that help ordering the quiet moves, which don't get scores during move generation. They
+	 * are filled when a quiet move causes a beta cutoff:
+	 *  - killer moves: the last 2 quiet moves that cut off at a ply. At the same ply they will likely cut off again.
+	 *  - history: for each side, departure and destination square, how much cutoffs that move caused, weighted by depth.
+	 *  - counter moves: for each side and previous move (its departure and destination), the quiet move that refuted it.
+	 * Each search worker has its own tables. They are kept between searches, but aged with ageTables.
+	 */
+	class move_ordering_tables {
+
+		move killers[maxKillerPly][2];
+
+		unsigned int history[2][64][64];
+
+		move counterMoves[2][64][64];
+
+	public:
+		move_ordering_tables();
+
+		/*
+		 * Called before a new search: the killers are cleared (their plies are relative to the old root)
+		 * and the history scores are halved, so the new search can overwrite them quickly.
+		 */
+		void ageTables();
+
+		/*
+		 * Stores a quiet move that caused a beta cutoff at the given ply, with depth left. Updates the killers, the
+		 * history, and the counter move of the previous move (which can be NULLMOVE).
+		 */
+		void storeCutoff(unsigned int side, const move& m, unsigned int ply, unsigned int depthLeft, const move& previousMove);
+
+		//Killer moves of the ply, the index is 0 or 1. Returns NULLMOVE if there is no killer stored.
+		inline const move& getKiller(unsigned int ply, unsigned int index) const {
+			return ply < maxKillerPly ? killers[ply][index] : NULLMOVE;
+		}
+
+		//The history score of a quiet move.
+		inline unsigned int getHistory(unsigned int side, const move& m) const {
+			return history[side][m.getFromSquare()][m.getToSquare()];
+		}
+
+		//The move that refuted the previous move the last time, NULLMOVE if there is none.
+		inline const move& getCounterMove(unsigned int side, const move& previousMove) const {
+			return counterMoves[side][previousMove.getFromSquare()][previousMove.getToSquare()];
+		}
+	};
+
 }
 
 #endif /* SRC_ENGINE_MOVE_ORDERING_H_ */
@@ -0,0 +1,137 @@
+/*
+ * move_picker.cpp
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#include "move_picker.h"
+
+namespace tchess
+{
+	move_picker::move_picker(const chessboard& board, const game_information& info, const move& ttMove,
+			const move_ordering_tables& tables, unsigned int ply, const move& previousMove)
+		: ttMove(ttMove), stage(ttMoveStage), current(0), noisyEnd(0), quietStart(0), noisyOnly(false),
+		  killerIndex(0), tables(&tables), side(info.getSideToMove()), board(board), info(info), generated(false) {
+		validateTTMove();
+		killerCandidates[0] = tables.getKiller(ply, 0);
+		killerCandidates[1] = tables.getKiller(ply, 1);
+		killerCandidates[2] = previousMove == NULLMOVE ? NULLMOVE : tables.getCounterMove(side, previousMove);
+		if(killerCandidates[2] == killerCandidates[0] || killerCandidates[2] == killerCandidates[1]) {
+			killerCandidates[2] = NULLMOVE; //don't pick it twice
+		}
+	}
+
+	move_picker::move_picker(const chessboard& board, const game_information& info, const move& ttMove, bool noisyOnly)
+		: ttMove(ttMove), stage(ttMoveStage), current(0), noisyEnd(0), quietStart(0), noisyOnly(noisyOnly),
+		  killerIndex(0), tables(nullptr), side(info.getSideToMove()), board(board), info(info), generated(false) {
+		validateTTMove();
+	}
+
+	void move_picker::validateTTMove() {
+		if(ttMove == NULLMOVE) return;
+		//a key collision in the table can give a move of a different position, that must not be made on the board
+		move_generator generator(board, info);
+		if(!generator.isLegalMove(side, ttMove) || (noisyOnly && !ttMove.isCapture() && !ttMove.isPromotion())) {
+			ttMove = NULLMOVE;
+		}
+	}
+
+	void move_picker::generateMoves() {
+		move_generator generator(board, info);
+		if(noisyOnly) { //the quiet moves would never be picked, don't generate them
+			generator.generateLegalNoisyMoves(side, moves);
+		} else {
+			generator.generateLegalMoves(side, moves);
+		}
+		//captures and promotions to the front, in place
+		noisyEnd = 0;
+		for(unsigned int i = 0; i < moves.size(); ++i) {
+			if(moves[i].isCapture() || moves[i].isPromotion()) moves.swap(i, noisyEnd++);
+		}
+		quietStart = noisyEnd;
+		if(!(ttMove == NULLMOVE)) { //the move from the table is picked before, move it to the start of its stage, which will skip it
+			for(unsigned int i = 0; i < moves.size(); ++i) {
+				if(moves[i] == ttMove) {
+					if(i < noisyEnd) {
+						moves.swap(i, 0);
+						current = 1;
+					} else {
+						moves.swap(i, noisyEnd);
+						quietStart = noisyEnd + 1;
+					}
+					break;
+				}
+			}
+		}
+		generated = true;
+	}
+
+	unsigned int move_picker::size() {
+		if(!generated) generateMoves();
+		return moves.size();
+	}
+
+	move& move_picker::selectBest(unsigned int end) {
+		unsigned int best = current;
+		for(unsigned int i = current + 1; i < end; ++i) {
+			if(moves.getScore(i) > moves.getScore(best)) best = i;
+		}
+		if(best != current) moves.swap(best, current);
+		return moves[current++];
+	}
+
+	bool move_picker::nextMove(move& m) {
+		switch(stage) {
+		case ttMoveStage:
+			stage = noisyStage;
+			if(!(ttMove == NULLMOVE)) { //searched before the other moves are generated, it often cuts off
+				m = ttMove;
+				return true;
+			}
+			// fall through
+		case noisyStage:
+			if(!generated) generateMoves();
+			if(current < noisyEnd) {
+				m = selectBest(noisyEnd);
+				return true;
+			}
+			if(noisyOnly) {
+				stage = doneStage;
+				return false;
+			}
+			stage = killerStage;
+			// fall through
+		case killerStage:
+			//the killers and the counter move are only played if they are quiet moves of this position
+			while(tables != nullptr && killerIndex < 3) {
+				const move& candidate = killerCandidates[killerIndex++];
+				if(candidate == NULLMOVE || candidate == ttMove) continue;
+				for(unsigned int i = quietStart; i < moves.size(); ++i) {
+					if(moves[i] == candidate) {
+						moves.swap(i, quietStart);
+						m = moves[quietStart++]; //skipped in the quiet stage
+						return true;
+					}
+				}
+			}
+			stage = quietStage;
+			current = quietStart;
+			if(tables != nullptr) { //score the remaining quiet moves by history
+				for(unsigned int i = quietStart; i < moves.size(); ++i) {
+					moves.setScore(i, tables->getHistory(side, moves[i]));
+				}
+			}
+			// fall through
+		case quietStage:
+			if(current < moves.size()) {
+				m = selectBest(moves.size());
+				return true;
+			}
+			stage = doneStage;
+			// fall through
+		default:
+			return false;
+		}
+	}
+}
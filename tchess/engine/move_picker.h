@@ -0,0 +1,111 @@
+/*
+ * move_picker.h
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_ENGINE_MOVE_PICKER_H_
+#define SRC_ENGINE_MOVE_PICKER_H_
+
+#include "board/board.h"
+#include "move_ordering.h"
+
+namespace tchess
+{
+	/*
+	 * Hands out the legal moves of a node in the order that the search should try them, in stages:
+	 *  - the best move from the transposition table, checked to be legal. The other moves are only generated
+	 *    after it was searched, so if it cuts off, there is no move generation in the node,
+	 *  - captures and promotions, by their MVV-LVA scores,
+	 *  - the killer moves of the ply and the counter move of the previous move, if they are legal here,
+	 *  - the other quiet moves, by their history scores.
+	 * The moves are generated into a list on the stack, and in each stage the next move is selected
+	 * only when it is asked for (partial selection sort). Most nodes cut off after the first few moves, so
+	 * sorting the whole list would be a waste.
+	 */
+	class move_picker {
+
+		//Stages of the picker, in order.
+		enum stage_type { ttMoveStage, noisyStage, killerStage, quietStage, doneStage };
+
+		//The legal moves, captures and promotions first.
+		move_list moves;
+
+		//Move from the transposition table, or NULLMOVE.
+		move ttMove;
+
+		stage_type stage;
+
+		//Index of the next move to be selected.
+		unsigned int current;
+
+		//End of the captures and promotions in the list.
+		unsigned int noisyEnd;
+
+		//Where the quiet moves start, after the transposition table move if that was quiet.
+		unsigned int quietStart;
+
+		//If only captures and promotions are needed, for example in the quiescence search.
+		bool noisyOnly;
+
+		//Killer moves and counter move to try after the captures, NULLMOVE if a slot is empty.
+		move killerCandidates[3];
+
+		//Index of the next killer candidate.
+		unsigned int killerIndex;
+
+		//History scores for the quiet moves, null if there are none.
+		const move_ordering_tables* tables;
+
+		//Side to move.
+		unsigned int side;
+
+		//The position, which must be the same whenever a move is picked.
+		const chessboard& board;
+		const game_information& info;
+
+		//If the moves are generated yet.
+		bool generated;
+
+	public:
+		move_picker() = delete;
+
+		/*
+		 * Picker for the main search. The killers and the counter move (of the previous move) are
+		 * taken from the tables, which also give the history scores.
+		 */
+		move_picker(const chessboard& board, const game_information& info, const move& ttMove,
+				const move_ordering_tables& tables, unsigned int ply, const move& previousMove);
+
+		//Picker without the quiet move tables. In noisy only mode only captures and promotions are picked.
+		move_picker(const chessboard& board, const game_information& info, const move& ttMove, bool noisyOnly = false);
+
+		/*
+		 * Puts the next move into the parameter. Returns false when there are no more moves. All
+		 * moves are legal.
+		 */
+		bool nextMove(move& m);
+
+		/*
+		 * Amount of legal moves in the position, in noisy only mode only the captures and promotions. This
+		 * generates the moves, if they were not generated yet.
+		 */
+		unsigned int size();
+
+	private:
+		//Drops the transposition table move if it is not legal in the position.
+		void validateTTMove();
+
+		/*
+		 * Generates the moves (in noisy only mode only the captures and promotions) and puts the captures and
+		 * promotions to the front, except the transposition table move.
+		 */
+		void generateMoves();
+
+		//Selects the highest scored move between the current index and the end, and moves it to the current index.
+		move& selectBest(unsigned int end);
+	};
+}
+
+#endif /* SRC_ENGINE_MOVE_PICKER_H_ */
@@ -14,23 +14,18 @@
 #define SRC_ENGINE_POLYGLOT_H_
 
 #include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+#include <list>
+#include <unordered_map>
+#include <mutex>
+#include <random>
 
-#include "board/board.h"
-
-#ifdef _MSC_VER
-#  define U64(u) (u##ui64)
-#else
-#  define U64(u) (u##ULL)
-#endif
-
-//Unsigned 64 bit integer type definition.
-typedef unsigned long long uint64;
+#include "board/board.h" //<- includes the random numbers and the uint64 typedef
 
 namespace tchess
 {
-	//Random array used by polyglot books AND the transposition table.
-	extern const uint64 Random64[781];
-
 	/*
 	 * Represents one entry in a binary polyglot book.
 	 */
@@ -50,28 +45,130 @@ namespace tchess
 
 	};
 
+	//A move of a position in the opening book, with its weight.
+	struct book_move {
+		move m;
+		unsigned short weight;
+	};
+
+	//The moves of one position in the opening book.
+	typedef std::vector<book_move> book_moves;
+
+	//Amount of positions that the book move cache of a book file holds.
+	const size_t bookCacheSize = 4096;
+
 	/*
-	 * Represents the polyglot opening book. At creation it will read the contents
-	 * of the opening book into memory.
+	 * A polyglot book file mapped into the memory read only. The operating system loads the pages
+	 * of the file when they are first read, so only the parts that the lookups touch are loaded. Use
+	 * open to get it: the engines that use the same file share one mapping.
 	 */
-	class opening_book {
+	class book_file {
 
 		//Amount of entries in the book.
-		long entriesNumber;
+		size_t entriesNumber;
+
+		//Points to the start of the mapped file.
+		const polyglot_book_entry* entries;
+
+#ifdef _WIN32
+		//Handles of the file and of the mapping.
+		void* fileHandle;
+		void* mappingHandle;
+#else
+		//Size of the mapping in bytes.
+		size_t mappedSize;
+#endif
+
+		//A position in the book move cache.
+		struct cached_position {
+			uint64 boardKey;
+			std::shared_ptr<const book_moves> moves;
+		};
+
+		/*
+		 * Cache of the decoded moves of the recently probed positions, the most recently used is at the
+		 * front. The same opening positions are probed again and again in a series of games, and the engines
+		 * share this with the mapping, so it is guarded by the mutex.
+		 */
+		mutable std::list<cached_position> cache;
+		mutable std::unordered_map<uint64, std::list<cached_position>::iterator> cacheIndex;
+		mutable std::mutex cacheMutex;
+
+		//Finds and decodes the moves of a position in the mapped file, with binary search.
+		std::shared_ptr<const book_moves> readMoves(uint64 boardKey, const chessboard& board, const game_information& info) const;
+
+		//Maps the file, throws if it can't be opened or it is empty.
+		explicit book_file(const std::string& path);
+
+	public:
+		book_file(const book_file&) = delete;
+		book_file& operator=(const book_file&) = delete;
+
+		~book_file();
+
+		/*
+		 * Returns the mapping of the book file. If the file is already mapped by another engine, that
+		 * mapping is returned. The file is unmapped when no engine uses it anymore.
+		 */
+		static std::shared_ptr<const book_file> open(const std::string& path);
+
+		/*
+		 * Returns the book moves of the position (empty if it is not in the book). The moves are taken
+		 * from the cache if the position was probed recently, otherwise they are read from the file and cached.
+		 */
+		std::shared_ptr<const book_moves> findMoves(const chessboard& board, const game_information& info) const;
+
+		inline size_t size() const {
+			return entriesNumber;
+		}
+
+		inline const polyglot_book_entry* begin() const {
+			return entries;
+		}
+
+		inline const polyglot_book_entry* end() const {
+			return entries + entriesNumber;
+		}
+	};
+
+	/*
+	 * Represents the polyglot opening book. The entries of a polyglot book are sorted by the board
+	 * key, so the moves of a position are found with binary search in the mapped book file. The book is
+	 * optional: without a book file it finds no moves.
+	 */
+	class opening_book {
+
+		//The mapped book file, shared with the other engines. Null if there is no book.
+		std::shared_ptr<const book_file> file;
 
-		//Points to the entries in the memory.
-		polyglot_book_entry* entries;
+		//Selects from the book moves, seeded differently for each engine.
+		std::mt19937 generator;
 
 	public:
-		opening_book();
+		/*
+		 * Opens the book file at the path. If the path is empty, or the file is missing or can't be
+		 * mapped, there is no book.
+		 */
+		explicit opening_book(const std::string& path);
 
-		~opening_book();
+		//If a book file was opened.
+		inline bool isOpen() const {
+			return file != nullptr;
+		}
 
 		/*
 		 * Extract a move from the opening book to the given board position. If there is no
 		 * move found for the position, then the special invalid move (0,0,quietMove) is returned.
 		 */
 		move getBookMove(const chessboard& board, const game_information& info);
+
+		/*
+		 * Loads the positions after the book replies to the given position into the cache, so that the
+		 * next probe of the engine is served from there. Called after the engine played its book move, with
+		 * the position that the opponent moves in. The engine calls it on another thread: it only uses the book
+		 * file, whose cache is thread safe.
+		 */
+		void prefetchReplies(const chessboard& board, const game_information& info);
 	};
 
 	/*
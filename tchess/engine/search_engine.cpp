@@ -0,0 +1,117 @@
+/*
+ * search_engine.cpp
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#include <string>
+#include <vector>
+#include <thread>
+
+#include "search_engine.h"
+
+namespace tchess
+{
+	unsigned int engine_depth = 12;
+
+	unsigned int engine_time_budget = 5000;
+
+	unsigned long long engine_node_budget = 0;
+
+	unsigned int engine_threads = std::thread::hardware_concurrency() > 0 ? std::thread::hardware_concurrency() : 1;
+
+	unsigned int engine_hash_size = def_transposition_table_size;
+
+	bool engine_huge_pages = true;
+
+	std::string engine_book_path = "res/codekiddy.bin";
+
+	bool engine_null_move_pruning = true;
+
+	bool engine_late_move_reductions = true;
+
+	bool engine_futility_pruning = true;
+
+	bool engine_reverse_futility_pruning = true;
+
+	search_engine::search_engine(search_listener* listener, unsigned int depth, unsigned int timeBudget,
+			unsigned long long nodeBudget, unsigned int threadCount, unsigned int hashSize, const std::string& bookPath)
+		: depth(depth), timeBudget(timeBudget), nodeBudget(nodeBudget), openingBook(bookPath),
+		  opening(USE_OPENING_BOOK && openingBook.isOpen()), listener(listener) {
+		ttable = new transposition_table(hashSize, engine_huge_pages);
+		searchState.nullMovePruning = engine_null_move_pruning;
+		searchState.lateMoveReductions = engine_late_move_reductions;
+		searchState.futilityPruning = engine_futility_pruning;
+		searchState.reverseFutilityPruning = engine_reverse_futility_pruning;
+		if(threadCount == 0) threadCount = 1;
+		workers.reserve(threadCount);
+		for(unsigned int i = 0; i < threadCount; ++i) {
+			workers.emplace_back(i, searchState, listener);
+		}
+		helperThreads = new thread_pool(threadCount - 1);
+		prefetchThread = new thread_pool(1);
+	}
+
+	void search_engine::setPosition(const chessboard& board, const game_information& info) {
+		this->board = board;
+		this->info = info;
+		opening = USE_OPENING_BOOK && openingBook.isOpen();
+	}
+
+	void search_engine::makeMove(const move& m) {
+		board.makeMove(m, info.getSideToMove());
+		updateGameInformation(board, m, info);
+	}
+
+	move search_engine::findBestMove() {
+		move bookMove = NULLMOVE;
+		if(opening) bookMove = openingBook.getBookMove(board, info);
+		if(!(bookMove == NULLMOVE)) { //found a book opening
+			if(listener != nullptr) listener->bookMoveFound();
+			/*
+			 * The book moves after the likely replies of the opponent are needed next. They are loaded on
+			 * the prefetch thread, so the move is returned without waiting for it (the book cache is thread safe).
+			 */
+			prefetchThread->wait(); //the previous prefetch must be done before its position is replaced
+			prefetchBoard = board;
+			prefetchInfo = info;
+			prefetchBoard.makeMove(bookMove, prefetchInfo.getSideToMove());
+			updateGameInformation(prefetchBoard, bookMove, prefetchInfo);
+			prefetchThread->start([this](unsigned int) { openingBook.prefetchReplies(prefetchBoard, prefetchInfo); });
+			return bookMove;
+		}
+		if(listener != nullptr) listener->searchStarted();
+		opening = false; //not in the opening anymore
+		return searchBestMove();
+	}
+
+	move search_engine::searchBestMove() {
+		searchState.ttable = ttable;
+		ttable->newSearch(); //entries of the earlier searches may be replaced now
+		searchState.stop = false;
+		searchState.nodeCount = 0;
+		searchState.searchStart = std::chrono::steady_clock::now();
+		searchState.maxDepth = depth;
+		searchState.timeBudget = timeBudget;
+		searchState.nodeBudget = nodeBudget;
+		for(search_worker& worker : workers) {
+			worker.setPosition(board, info);
+		}
+		helperThreads->start([this](unsigned int index) { workers[index + 1].search(); });
+		workers[0].search(); //the main worker stops the helpers when it is done
+		helperThreads->wait();
+		//a helper may have completed a deeper iteration than the main worker
+		const search_worker* bestWorker = &workers[0];
+		search_statistics statistics;
+		for(const search_worker& worker : workers) {
+			if(worker.getCompletedDepth() > bestWorker->getCompletedDepth()) bestWorker = &worker;
+			statistics += worker.getStatistics();
+		}
+		if(listener != nullptr) {
+			listener->searchFinished((unsigned int)workers.size(), searchState.nodeCount, searchState.elapsedMilliseconds(),
+					bestWorker->getCompletedDepth(), statistics);
+		}
+		return bestWorker->getBestMove();
+	}
+}
@@ -0,0 +1,193 @@
+/*
+ * search_engine.h
+ *
+ * The core of the Tchess engine without any GUI: it keeps its own position, plays from the
+ * opening book and searches with the workers. The engine player of the GUI uses it, and it can be
+ * built into a static library on its own (see CMakeLists.txt).
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_ENGINE_SEARCH_ENGINE_H_
+#define SRC_ENGINE_SEARCH_ENGINE_H_
+
+#define USE_OPENING_BOOK true
+
+#include <string>
+#include <vector>
+
+#include "board/board.h"
+#include "polyglot.h"
+#include "transposition_table.h"
+#include "search_worker.h"
+#include "search_listener.h"
+#include "thread_pool.h"
+
+namespace tchess
+{
+	/*
+	 * Maximum tree search depth used by the engine. The engine deepens the search iteratively
+	 * until this depth is reached or the budgets below run out.
+	 */
+	extern unsigned int engine_depth;
+
+	/*
+	 * Time budget of the engine for one move, in milliseconds.
+	 */
+	extern unsigned int engine_time_budget;
+
+	/*
+	 * Node budget of the engine for one move, 0 means no limit.
+	 */
+	extern unsigned long long engine_node_budget;
+
+	/*
+	 * Amount of threads that the engine searches with, by default one for each core.
+	 */
+	extern unsigned int engine_threads;
+
+	/*
+	 * Size of the transposition table of the engine in megabytes.
+	 */
+	extern unsigned int engine_hash_size;
+
+	/*
+	 * If the transposition table should use huge pages, where the system supports it.
+	 */
+	extern bool engine_huge_pages;
+
+	/*
+	 * Path of the polyglot opening book of the engine, relative to the working directory. If it is empty
+	 * or the file is missing, the engine plays without a book.
+	 */
+	extern std::string engine_book_path;
+
+	/*
+	 * If the engine uses null move pruning.
+	 */
+	extern bool engine_null_move_pruning;
+
+	/*
+	 * If the engine uses late move reductions.
+	 */
+	extern bool engine_late_move_reductions;
+
+	/*
+	 * If the engine uses futility pruning.
+	 */
+	extern bool engine_futility_pruning;
+
+	/*
+	 * If the engine uses reverse futility pruning.
+	 */
+	extern bool engine_reverse_futility_pruning;
+
+	/*
+	 * Finds moves for a position, first from the opening book, then with the search. The moves of both
+	 * sides must be made on it with makeMove, so that it always knows the position of the game.
+	 */
+	class search_engine {
+
+		//Maximum search depth.
+		unsigned int depth;
+
+		//Time budget for one move in milliseconds.
+		unsigned int timeBudget;
+
+		//Node budget for one move, 0 if there is no limit.
+		unsigned long long nodeBudget;
+
+		//Board object.
+		chessboard board;
+
+		//game info object.
+		game_information info;
+
+		//Polyglot opening book, it may have no book file.
+		opening_book openingBook;
+
+		//Stores if the engine is playing opening mode (from book) or not.
+		bool opening;
+
+		/*
+		 * The transposition table used by the engine, shared by all search threads.
+		 */
+		transposition_table* ttable;
+
+		//Data shared by the search workers during a search.
+		shared_search_state searchState;
+
+		/*
+		 * One search worker for each thread. The first one is the main worker, which runs
+		 * on the calling thread, the others run on the helper threads.
+		 */
+		std::vector<search_worker> workers;
+
+		//Threads of the helper workers.
+		thread_pool* helperThreads;
+
+		/*
+		 * One thread that loads the book moves after the likely replies into the book cache, while the
+		 * opponent thinks. It works on the position after the last book move of the engine.
+		 */
+		thread_pool* prefetchThread;
+		chessboard prefetchBoard;
+		game_information prefetchInfo;
+
+		//Receives the progress of the searches, may be null.
+		search_listener* listener;
+
+	public:
+		/*
+		 * Creates an engine at the start position. The listener receives the progress of the searches,
+		 * it may be null. The opening book is read from the book path, without it the engine always searches.
+		 */
+		search_engine(search_listener* listener, unsigned int depth = engine_depth, unsigned int timeBudget = engine_time_budget,
+				unsigned long long nodeBudget = engine_node_budget, unsigned int threadCount = engine_threads,
+				unsigned int hashSize = engine_hash_size, const std::string& bookPath = engine_book_path);
+
+		//The workers and the helper threads refer to the engine, it can't be copied.
+		search_engine(const search_engine&) = delete;
+		search_engine& operator=(const search_engine&) = delete;
+
+		~search_engine() {
+			delete prefetchThread; //waits for the prefetch, which uses the opening book
+			delete helperThreads;
+			delete ttable;
+		}
+
+		/*
+		 * Continues from another position, for example one loaded from FEN. The opening
+		 * book is tried again.
+		 */
+		void setPosition(const chessboard& board, const game_information& info);
+
+		//Makes a move of the side to move on the engine's position.
+		void makeMove(const move& m);
+
+		/*
+		 * Finds the best move for the side to move: from the opening book while it has one, then as
+		 * deep as the depth, time and node budgets allow. The move is not made.
+		 */
+		move findBestMove();
+
+		inline const chessboard& getBoard() const {
+			return board;
+		}
+
+		inline const game_information& getInfo() const {
+			return info;
+		}
+
+	private:
+		/*
+		 * Searches the current position with all workers (lazy SMP), each of them with
+		 * iterative deepening. When the main worker is done the helpers are stopped, and the best move of
+		 * the worker with the deepest completed iteration is returned.
+		 */
+		move searchBestMove();
+	};
+}
+
+#endif /* SRC_ENGINE_SEARCH_ENGINE_H_ */
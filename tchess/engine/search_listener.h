@@ -0,0 +1,57 @@
+/*
+ * search_listener.h
+ *
+ * Interface that receives the progress of the engine's search, so that the engine does not depend on
+ * the GUI and does not print anything itself. The GUI implements it with window messages and console output,
+ * headless programs can report or ignore the progress as they like.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_ENGINE_SEARCH_LISTENER_H_
+#define SRC_ENGINE_SEARCH_LISTENER_H_
+
+#include "board/move.h"
+
+namespace tchess
+{
+	struct search_statistics;
+
+	/*
+	 * Progress of a search. Only the main search worker calls these, from the thread that the
+	 * search runs on, so an implementation must not block and must be safe to call from that thread.
+	 */
+	class search_listener {
+	public:
+		virtual ~search_listener() {}
+
+		//The legal moves of the root are generated, there are this many of them.
+		virtual void rootMovesGenerated(unsigned int moveCount) = 0;
+
+		//In the current iteration this many root moves are searched.
+		virtual void rootMovesSearched(unsigned int searchedCount) = 0;
+
+		//The move was found in the opening book, there is no search.
+		virtual void bookMoveFound() = 0;
+
+		//The position is not in the opening book, a search starts.
+		virtual void searchStarted() = 0;
+
+		/*
+		 * An iteration of the main worker is completed at the depth, with its best move and score. The piece that makes
+		 * the move is passed so that the move can be printed. The nodes and the milliseconds are counted since the search started.
+		 */
+		virtual void iterationCompleted(unsigned int depth, const move& bestMove, int pieceThatMoved, int score,
+				unsigned long long nodes, long long milliseconds) = 0;
+
+		/*
+		 * The search is done. The nodes and the statistics are the sums of all workers, the depth is the
+		 * deepest completed iteration.
+		 */
+		virtual void searchFinished(unsigned int threadCount, unsigned long long nodes, long long milliseconds,
+				unsigned int depth, const search_statistics& statistics) = 0;
+	};
+}
+
+#endif /* SRC_ENGINE_SEARCH_LISTENER_H_ */
@@ -0,0 +1,399 @@
+/*
+ * search_worker.cpp
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#include <vector>
+#include <algorithm>
+#include <cstdlib>
+
+#include "search_worker.h"
+#include "move_picker.h"
+#include "board/evaluation.h"
+
+namespace tchess
+{
+	//The workers add their node counts to the shared count and check if they must stop after this many nodes (must be a power of 2).
+	static const unsigned long long budgetCheckInterval = 2048;
+
+	//Quiescence search stops after this many plies, and evaluates the position as it is.
+	static const unsigned int maxQuiescenceDepth = 8;
+
+	/*
+	 * The quiescence search counts the moves of each side for the mobility only once, this marks
+	 * that a side was not counted yet.
+	 */
+	static const unsigned int unknownMobility = ~0u;
+
+	//Delta pruning skips a capture if even winning the captured piece and this much more can't raise alpha.
+	static const int deltaMargin = 200;
+
+	//Starting half width of the aspiration window around the score of the previous iteration.
+	static const int aspirationWindow = 50;
+
+	//Aspiration windows are used from this depth, the first iterations are fast anyway.
+	static const unsigned int aspirationMinDepth = 4;
+
+	//Null move pruning is only tried with at least this much depth left.
+	static const unsigned int nullMoveMinDepth = 3;
+
+	//Late move reductions start after this many moves were searched in a node.
+	static const unsigned int lateMoveMinMoves = 3;
+
+	//Late move reductions are only done with at least this much depth left.
+	static const unsigned int lateMoveMinDepth = 3;
+
+	//Futility pruning is done in nodes with at most this much depth left, the margin grows with the depth.
+	static const unsigned int futilityMaxDepth = 2;
+	static const int futilityMargin = 200;
+
+	//Reverse futility pruning is done in nodes with at most this much depth left, the margin grows with the depth.
+	static const unsigned int reverseFutilityMaxDepth = 3;
+	static const int reverseFutilityMargin = 120;
+
+	//Checks if a score means mate, these must not be pruned with the margins.
+	static inline bool isMateScore(int score) {
+		return score <= WORST_VALUE + 1000 || score >= BEST_VALUE - 1000;
+	}
+
+	/*
+	 * Converts a score to be stored in the transposition table. The mate scores are relative to the root (see
+	 * isSpecialBoard), but the same position can be reached at another ply, and the table is shared by the threads.
+	 * So the table stores the mate distance from the node instead.
+	 */
+	static inline int scoreToTable(int score, unsigned int ply) {
+		if(score <= WORST_VALUE + 1000) return score - (int)ply; //mated
+		if(score >= BEST_VALUE - 1000) return score + (int)ply; //mates
+		return score;
+	}
+
+	//Converts a score from the transposition table back to be relative to the root, for a node at the given ply.
+	static inline int scoreFromTable(int score, unsigned int ply) {
+		if(score <= WORST_VALUE + 1000) return score + (int)ply;
+		if(score >= BEST_VALUE - 1000) return score - (int)ply;
+		return score;
+	}
+
+	//Checks if a side has any pieces other than pawns and the king. Without them zugzwang is common, so no null move is tried.
+	static inline bool hasNonPawnMaterial(const chessboard& board, unsigned int side) {
+		return (board.getPieces(side) ^ board.getPieces(side, pawn) ^ board.getPieces(side, king)) != emptyBitboard;
+	}
+
+	//Keeps a window bound between the worst and best values.
+	static inline int clampScore(long long score) {
+		return score < WORST_VALUE ? WORST_VALUE : (score > BEST_VALUE ? BEST_VALUE : (int)score);
+	}
+
+	void search_worker::setPosition(const chessboard& board, const game_information& info) {
+		pos.set(board, info);
+	}
+
+	void search_worker::search() {
+		searchAborted = false;
+		nodeCount = 0;
+		statistics = search_statistics();
+		orderingTables.ageTables();
+		completedDepth = 0;
+		bestEvaluation = 0;
+		//create legal moves for this board and side, in the order of the move picker
+		std::vector<move> moves;
+		move_picker picker(pos.getBoard(), pos.getInfo(), NULLMOVE, orderingTables, 0, NULLMOVE);
+		move pickedMove;
+		while(picker.nextMove(pickedMove)) {
+			moves.push_back(pickedMove);
+		}
+		if(id == 0 && listener != nullptr) { //got moves, report their amount
+			listener->rootMovesGenerated(moves.size());
+		}
+		bestMove = moves.empty() ? NULLMOVE : moves.front();
+		for(searchDepth = 1; searchDepth <= shared.maxDepth && !moves.empty(); ++searchDepth) { //iterative deepening
+			//helpers skip every second depth, odd and even helpers different ones
+			if(id != 0 && searchDepth > 1 && (searchDepth + id) % 2 == 1) continue;
+			/*
+			 * Aspiration window: the score will probably be close to the previous one, so search with a narrow
+			 * window around it. If the score falls outside, widen the window on that side and search again.
+			 */
+			int alpha = WORST_VALUE, beta = BEST_VALUE;
+			long long delta = aspirationWindow;
+			if(searchDepth >= aspirationMinDepth && completedDepth > 0) {
+				alpha = clampScore((long long)bestEvaluation - delta);
+				beta = clampScore((long long)bestEvaluation + delta);
+			}
+			int evaluation;
+			move iterationBestMove;
+			while(true) {
+				iterationBestMove = alphaBetaNegamaxRoot(moves, alpha, beta, evaluation);
+				if(searchAborted) break;
+				if(evaluation <= alpha && alpha > WORST_VALUE) { //failed low
+					delta *= 4;
+					alpha = clampScore((long long)evaluation - delta);
+				} else if(evaluation >= beta && beta < BEST_VALUE) { //failed high
+					delta *= 4;
+					beta = clampScore((long long)evaluation + delta);
+				} else {
+					break; //the score is inside the window
+				}
+			}
+			if(searchAborted) break; //the unfinished iteration is thrown away
+			bestMove = iterationBestMove;
+			bestEvaluation = evaluation;
+			completedDepth = searchDepth;
+			if(id == 0) {
+				if(listener != nullptr) {
+					listener->iterationCompleted(searchDepth, bestMove, std::abs(pos.getBoard()[bestMove.getFromSquare()]), bestEvaluation,
+							shared.nodeCount + nodeCount, shared.elapsedMilliseconds());
+				}
+				//the next iteration takes longer than all the previous ones, don't start it if it can't finish
+				if(2 * shared.elapsedMilliseconds() >= shared.timeBudget) break;
+				if(shared.nodeBudget > 0 && 2 * (shared.nodeCount + nodeCount) >= shared.nodeBudget) break;
+			}
+		}
+		shared.nodeCount += nodeCount;
+		nodeCount = 0;
+		if(id == 0) shared.stop = true; //the helpers stop when the main worker is done
+	}
+
+	move search_worker::alphaBetaNegamaxRoot(std::vector<move>& moves, int alpha, int beta, int& evaluation) {
+		//we cant be at maximum depth, since this is the root call
+		move iterationBestMove = moves.front();
+		int bestEvaluation = WORST_VALUE;
+		int count = 0;
+		for(auto it = moves.begin(); it != moves.end(); it++) { //iterate legal moves
+			move& _move = *it;
+			pos.makeMove(_move);
+			int moveEvaluation;
+			if(count == 0) { //the first move is searched with the full window
+				moveEvaluation = -alphaBetaNegamax(-beta, -alpha, searchDepth-1, 1); //move down in the tree
+			} else { //the others only have to prove that they are not better
+				moveEvaluation = -alphaBetaNegamax(-alpha-1, -alpha, searchDepth-1, 1);
+				if(moveEvaluation > alpha && moveEvaluation < beta) { //it is better, search again for the exact score
+					moveEvaluation = -alphaBetaNegamax(-beta, -alpha, searchDepth-1, 1);
+				}
+			}
+			pos.unmakeMove(); //unmake the move before moving on
+			if(searchAborted) break; //the evaluation is not valid
+			if(moveEvaluation > bestEvaluation || count == 0) {
+				bestEvaluation = moveEvaluation;
+				iterationBestMove = _move;
+			}
+			if(bestEvaluation > alpha) alpha = bestEvaluation;
+			//finished with this move, report the progress
+			++count;
+			if(id == 0 && listener != nullptr) {
+				listener->rootMovesSearched(count);
+			}
+			if(bestEvaluation >= beta) break; //failed high, the window will be widened
+		}
+		if(!searchAborted) { //search the best move first in the next iteration
+			auto bestIt = std::find(moves.begin(), moves.end(), iterationBestMove);
+			std::rotate(moves.begin(), bestIt, bestIt + 1);
+		}
+		evaluation = bestEvaluation;
+		return iterationBestMove;
+	}
+
+	void search_worker::countNode() {
+		if(++nodeCount < budgetCheckInterval) return;
+		shared.nodeCount += nodeCount;
+		nodeCount = 0;
+		if(id == 0 && searchDepth > 1) { //the first iteration always finishes
+			if(shared.elapsedMilliseconds() >= shared.timeBudget || (shared.nodeBudget > 0 && shared.nodeCount >= shared.nodeBudget)) {
+				shared.stop = true;
+			}
+		}
+		if(shared.stop.load(std::memory_order_relaxed)) {
+			searchAborted = true;
+		}
+	}
+
+	int search_worker::alphaBetaNegamax(int alpha, int beta, unsigned int depthLeft, unsigned int ply) {
+		if(depthLeft == 0) { //we are at maximum search depth, resolve the captures then evaluate
+			return quiescence(alpha, beta, ply, 0, unknownMobility, unknownMobility);
+		}
+		countNode();
+		if(searchAborted) return 0; //unwind, the result is not used
+		const chessboard& board = pos.getBoard();
+		const game_information& gameInfo = pos.getInfo();
+		unsigned int side = gameInfo.getSideToMove();
+		move previousMove = pos.getLastMove(); //NULLMOVE after a null move
+		int alphaOriginal = alpha;
+		//look up position in transposition table
+		uint64 zobristKey = pos.getHashKey();
+#ifndef NDEBUG
+		verifyZobristHash(zobristKey, board, gameInfo); //the incremental key must match the recomputed one
+#endif
+		transposition_entry entry;
+		move ttMove = NULLMOVE; //best move of an earlier search of this position
+		if(shared.ttable->probe(zobristKey, entry)) {
+			ttMove = entry.bestMove;
+			entry.score = scoreFromTable(entry.score, ply);
+			if(entry.depth >= depthLeft) {
+				//found in transposition table
+				shared.ttable->markUseful(zobristKey); //mark this as useful
+				if(entry.entryType == exact) { //exact match
+					return entry.score;
+				} else if(entry.entryType == lowerBound && entry.score > alpha) {
+					alpha = entry.score;
+				} else if(entry.entryType == upperBound && entry.score < beta) {
+					beta = entry.score;
+				}
+				if(alpha >= beta) return entry.score;
+			}
+		}
+		//the moves come in stages: transposition table move (before generating the others), captures, killers, quiet moves
+		move_picker picker(board, gameInfo, ttMove, orderingTables, ply, previousMove);
+		/*
+		 * Forward pruning, only in null window nodes (not on the principal variation) and never when in check.
+		 */
+		bool pvNode = isPvWindow(alpha, beta);
+		bool inCheck = isAttacked(board, 1-side, board.getKingSquare(side));
+		/*
+		 * Static evaluation for the pruning, only computed when a pruning needs it (not in check). The mobility
+		 * only needs the amount of moves, the picker generates them later, if the hash move doesn't cut off.
+		 */
+		int staticEvaluation = 0;
+		bool staticEvaluated = false;
+		auto getStaticEvaluation = [&]() {
+			if(!staticEvaluated) {
+				staticEvaluation = evaluateBoard(side, board, gameInfo, move_generator(board, gameInfo).countPseudoLegalMoves(side), &pawnHashTable);
+				staticEvaluated = true;
+			}
+			return staticEvaluation;
+		};
+		if(!pvNode && !inCheck && !isMateScore(beta)) {
+			//reverse futility pruning: so far above beta that the last few plies will hardly bring it back
+			if(shared.reverseFutilityPruning && depthLeft <= reverseFutilityMaxDepth
+					&& getStaticEvaluation() - reverseFutilityMargin * (int)depthLeft >= beta) {
+				++statistics.reverseFutilityCutoffs;
+				return beta;
+			}
+			//null move pruning: if passing the move still fails high with a reduced search, a real move will too
+			if(shared.nullMovePruning && !(previousMove == NULLMOVE) && depthLeft >= nullMoveMinDepth
+					&& hasNonPawnMaterial(board, side) && getStaticEvaluation() >= beta) {
+				unsigned int reduction = depthLeft > 6 ? 3 : 2;
+				pos.makeNullMove();
+				int evaluation = -alphaBetaNegamax(-beta, -beta + 1, depthLeft - 1 - reduction, ply + 1);
+				pos.unmakeNullMove();
+				if(searchAborted) return 0;
+				if(evaluation >= beta) {
+					++statistics.nullMoveCutoffs;
+					return beta;
+				}
+			}
+		}
+		//futility pruning: quiet moves can't raise alpha this close to the leaves
+		bool futile = shared.futilityPruning && !pvNode && !inCheck && depthLeft <= futilityMaxDepth
+				&& !isMateScore(alpha) && getStaticEvaluation() + futilityMargin * (int)depthLeft <= alpha;
+		int bestEvaluation = WORST_VALUE;
+		move bestMove;
+		unsigned int searchedMoves = 0;
+		move _move;
+		while(picker.nextMove(_move)) {
+			pos.makeMove(_move);
+			bool quiet = !_move.isCapture() && !_move.isPromotion() && !isAttacked(board, side, board.getKingSquare(1-side));
+			if(futile && quiet && searchedMoves > 0) {
+				pos.unmakeMove();
+				++statistics.futilityPrunedMoves;
+				continue;
+			}
+			int evaluation;
+			if(searchedMoves == 0) { //principal variation search: the first move gets the full window
+				evaluation = -alphaBetaNegamax(-beta, -alpha, depthLeft - 1, ply + 1); //move down in the tree
+			} else { //null window for the others, and if one turns out to be better, search it again with the full window
+				bool fullDepth = true;
+				if(shared.lateMoveReductions && quiet && !inCheck && depthLeft >= lateMoveMinDepth && searchedMoves >= lateMoveMinMoves) {
+					//late move reduction: quiet moves ordered late are searched less deep first
+					unsigned int reduction = (searchedMoves >= 6 && depthLeft >= 4) ? 2 : 1;
+					++statistics.lateMoveReductions;
+					evaluation = -alphaBetaNegamax(-alpha - 1, -alpha, depthLeft - 1 - reduction, ply + 1);
+					fullDepth = evaluation > alpha; //it was better than expected, verify it with the full depth
+					if(fullDepth) ++statistics.lateMoveResearches;
+				}
+				if(fullDepth) {
+					evaluation = -alphaBetaNegamax(-alpha - 1, -alpha, depthLeft - 1, ply + 1);
+					if(evaluation > alpha && evaluation < beta) {
+						evaluation = -alphaBetaNegamax(-beta, -alpha, depthLeft - 1, ply + 1);
+					}
+				}
+			}
+			++searchedMoves;
+			pos.unmakeMove(); //unmake the move before moving on
+			if(searchAborted) return 0; //the evaluation is not valid, don't store anything
+			if(evaluation > bestEvaluation) {
+				bestEvaluation = evaluation;
+				bestMove = _move;
+			}
+			if(bestEvaluation > alpha) {
+				alpha = bestEvaluation;
+			}
+			if(bestEvaluation >= beta) {
+				if(!_move.isCapture() && !_move.isPromotion()) { //remember the quiet moves that cut off
+					orderingTables.storeCutoff(side, _move, ply, depthLeft, previousMove);
+				}
+				break;
+			}
+		}
+		if(searchedMoves == 0) { //no legal moves: checkmate or stalemate, no matter how deep we are
+			return isSpecialBoard(side, board, false, ply).evaluation;
+		}
+		//store move in the transposition table
+		unsigned short entryType;
+		if(bestEvaluation <= alphaOriginal) {
+			entryType = upperBound;
+		} else if(bestEvaluation >= beta) {
+			entryType = lowerBound;
+		} else {
+			entryType = exact;
+		}
+		transposition_entry newEntry(entryType, depthLeft, scoreToTable(bestEvaluation, ply), bestMove);
+		shared.ttable->put(zobristKey, newEntry);
+		return alpha;
+	}
+
+	int search_worker::quiescence(int alpha, int beta, unsigned int ply, unsigned int quiescenceDepth, unsigned int mobility, unsigned int enemyMobility) {
+		countNode();
+		if(searchAborted) return 0; //unwind, the result is not used
+		const chessboard& board = pos.getBoard();
+		const game_information& gameInfo = pos.getInfo();
+		if(board.isInsufficientMaterial()) return 0; //draw without evaluation
+		unsigned int side = gameInfo.getSideToMove();
+		bool inCheck = isAttacked(board, 1-side, board.getKingSquare(side));
+		//only captures and promotions in MVV-LVA order, when in check all moves are searched
+		move_picker picker(board, gameInfo, NULLMOVE, !inCheck);
+		if(inCheck && picker.size() == 0) { //checkmate, only in check are the legal moves needed before the stand pat
+			return isSpecialBoard(side, board, false, ply).evaluation;
+		}
+		//the evaluation ignores the mobility in check, otherwise it is counted only the first time this side is to move
+		if(inCheck) {
+			mobility = 0;
+		} else if(mobility == unknownMobility) {
+			mobility = move_generator(board, gameInfo).countPseudoLegalMoves(side);
+		}
+		int standPat = evaluateBoard(side, board, gameInfo, mobility, &pawnHashTable);
+		if(quiescenceDepth >= maxQuiescenceDepth) return standPat; //don't go deeper
+		if(!inCheck) {
+			if(standPat >= beta) return standPat; //already good enough without capturing
+			if(standPat > alpha) alpha = standPat;
+		}
+		int bestEvaluation = inCheck ? WORST_VALUE : standPat;
+		move _move;
+		while(picker.nextMove(_move)) {
+			if(!inCheck && !_move.isPromotion()) { //delta pruning
+				int captured = _move.isEnPassant() ? pawn : std::abs(board[_move.getToSquare()]);
+				if(standPat + pieceValues[captured] + deltaMargin <= alpha) continue;
+			}
+			pos.makeMove(_move);
+			int evaluation = -quiescence(-beta, -alpha, ply + 1, quiescenceDepth + 1, enemyMobility, inCheck ? unknownMobility : mobility);
+			pos.unmakeMove(); //unmake the move before moving on
+			if(searchAborted) return 0; //the evaluation is not valid
+			if(evaluation > bestEvaluation) {
+				bestEvaluation = evaluation;
+				if(bestEvaluation > alpha) alpha = bestEvaluation;
+				if(bestEvaluation >= beta) break;
+			}
+		}
+		return bestEvaluation;
+	}
+}
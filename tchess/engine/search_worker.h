@@ -0,0 +1,234 @@
+/*
+ * search_worker.h
+ *
+ * The tree search of the engine. The engine runs one search worker on its own thread and
+ * the others on helper threads (lazy SMP): every worker searches the same root position on its own
+ * copy of the board, and they help each other only through the shared transposition table.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_ENGINE_SEARCH_WORKER_H_
+#define SRC_ENGINE_SEARCH_WORKER_H_
+
+#include <atomic>
+#include <chrono>
+
+#include "board/position.h"
+#include "board/pawn_hash_table.h"
+#include "transposition_table.h"
+#include "move_ordering.h"
+#include "search_listener.h"
+
+namespace tchess
+{
+	/*
+	 * Data of one search that all workers share.
+	 */
+	struct shared_search_state {
+
+		//The transposition table of the engine.
+		transposition_table* ttable;
+
+		//Set when the search must stop: the budget ran out or the main worker finished.
+		std::atomic<bool> stop;
+
+		//Nodes visited by all workers, the workers add their counts in batches.
+		std::atomic<unsigned long long> nodeCount;
+
+		//When the search started.
+		std::chrono::steady_clock::time_point searchStart;
+
+		//Maximum search depth.
+		unsigned int maxDepth;
+
+		//Time budget in milliseconds.
+		unsigned int timeBudget;
+
+		//Node budget, 0 if there is no limit.
+		unsigned long long nodeBudget;
+
+		//Which forward pruning techniques the search uses.
+		bool nullMovePruning;
+		bool lateMoveReductions;
+		bool futilityPruning;
+		bool reverseFutilityPruning;
+
+		shared_search_state() : ttable(nullptr), stop(false), nodeCount(0), maxDepth(0), timeBudget(0), nodeBudget(0),
+				nullMovePruning(true), lateMoveReductions(true), futilityPruning(true), reverseFutilityPruning(true) {}
+
+		//Milliseconds since the search started.
+		inline long long elapsedMilliseconds() const {
+			return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - searchStart).count();
+		}
+	};
+
+	/*
+	 * Counts how often the forward pruning techniques were used during a search.
+	 */
+	struct search_statistics {
+
+		//Nodes that were cut off because a reduced search after a null move failed high.
+		unsigned long long nullMoveCutoffs;
+
+		//Moves that were searched with reduced depth first.
+		unsigned long long lateMoveReductions;
+
+		//Reduced moves that had to be searched again with the full depth.
+		unsigned long long lateMoveResearches;
+
+		//Quiet moves that were skipped near the leaves.
+		unsigned long long futilityPrunedMoves;
+
+		//Nodes that were cut off because the static evaluation was far above beta.
+		unsigned long long reverseFutilityCutoffs;
+
+		search_statistics() : nullMoveCutoffs(0), lateMoveReductions(0), lateMoveResearches(0),
+				futilityPrunedMoves(0), reverseFutilityCutoffs(0) {}
+
+		search_statistics& operator+=(const search_statistics& other) {
+			nullMoveCutoffs += other.nullMoveCutoffs;
+			lateMoveReductions += other.lateMoveReductions;
+			lateMoveResearches += other.lateMoveResearches;
+			futilityPrunedMoves += other.futilityPrunedMoves;
+			reverseFutilityCutoffs += other.reverseFutilityCutoffs;
+			return *this;
+		}
+	};
+
+	/*
+	 * Checks if a window is wider than a null window, so the node is on the principal variation. The full window
+	 * spans almost all ints, so the width is computed in long long.
+	 */
+	inline bool isPvWindow(int alpha, int beta) {
+		return (long long)beta - alpha > 1;
+	}
+
+	/*
+	 * Searches a position with iterative deepening and alpha-beta negamax. Worker 0 is the main worker:
+	 * it checks the budgets, reports the progress and tells the others to stop when it is done. The helper
+	 * workers start some iterations one depth deeper, so that the threads don't all search the same nodes.
+	 */
+	class search_worker {
+
+		//Index of the worker, 0 is the main worker.
+		unsigned int id;
+
+		//Data shared with the other workers.
+		shared_search_state& shared;
+
+		//Receives the progress of the search, only used by the main worker. May be null.
+		search_listener* listener;
+
+		//Copy of the position that is searched, the moves are made and unmade on it.
+		position pos;
+
+		//Depth of the current iteration of iterative deepening.
+		unsigned int searchDepth;
+
+		//Nodes visited by this worker that were not yet added to the shared count.
+		unsigned long long nodeCount;
+
+		//Set when this worker must unwind, the results of the unfinished iteration are thrown away.
+		bool searchAborted;
+
+		//Best move of the last completed iteration.
+		move bestMove;
+
+		//Evaluation of the best move of the last completed iteration.
+		int bestEvaluation;
+
+		//Depth of the last completed iteration, 0 if there was none.
+		unsigned int completedDepth;
+
+		//Pruning counters of the last search.
+		search_statistics statistics;
+
+		//Killer, history and counter move tables of this worker.
+		move_ordering_tables orderingTables;
+
+		//Pawn structure evaluations of this worker, it is not shared so that it needs no locking.
+		pawn_hash_table pawnHashTable;
+
+	public:
+		search_worker(unsigned int id, shared_search_state& shared, search_listener* listener)
+			: id(id), shared(shared), listener(listener), searchDepth(0), nodeCount(0), searchAborted(false),
+			  bestEvaluation(0), completedDepth(0) {}
+
+		//Copies the position that the next search will start from.
+		void setPosition(const chessboard& board, const game_information& info);
+
+		/*
+		 * Searches the position with iterative deepening until the maximum depth is
+		 * reached or the search is stopped. The result is available from getBestMove.
+		 */
+		void search();
+
+		inline const move& getBestMove() const {
+			return bestMove;
+		}
+
+		inline int getBestEvaluation() const {
+			return bestEvaluation;
+		}
+
+		inline unsigned int getCompletedDepth() const {
+			return completedDepth;
+		}
+
+		inline const search_statistics& getStatistics() const {
+			return statistics;
+		}
+
+	private:
+		/*
+		 * Searches all root moves to the current depth, inside the given (aspiration) window. Unlike the normal
+		 * negamax, this will return the best move instead of the best evaluation. The first move gets the whole window,
+		 * the others a null window (principal variation search). The moves are reordered so that the best one is
+		 * searched first in the next iteration.
+		 */
+		move alphaBetaNegamaxRoot(std::vector<move>& moves, int alpha, int beta, int& evaluation);
+
+		/*
+		 * Negamax tree searching method with alpha-beta cutoff. It is a principal variation search: the first
+		 * move is searched with the full window, the others with a null window around alpha, and are only searched
+		 * again with the full window if they turn out to be better.
+		 * In null window nodes the tree is also pruned forward (each can be turned off with its engine option):
+		 *  - reverse futility pruning: near the leaves, if the static evaluation is above beta by a margin, the node fails high.
+		 *  - null move pruning: the side to move passes, and if a reduced search still fails high, so does the node. Not done
+		 *    without non pawn material, where zugzwang is likely, and never twice in a row.
+		 *  - futility pruning: near the leaves, if the static evaluation is below alpha by a margin, quiet moves are skipped.
+		 *  - late move reductions: quiet moves that come late in the ordering are searched with less depth first.
+		 * - depth left: Current search depth. If this is 0, then we dont go deeper and evaluate.
+		 * - ply: distance from the root, for the mate scores.
+		 * Quiet moves that cause a beta cutoff are stored in the move ordering tables, with the counter move
+		 * of the move that led here.
+		 */
+		int alphaBetaNegamax(int alpha, int beta, unsigned int depthLeft, unsigned int ply);
+
+		/*
+		 * Quiescence search, called instead of the evaluation at the end of the normal search. It only searches
+		 * captures and promotions (all moves when in check), until the position is quiet enough to evaluate:
+		 *  - stand pat: the side to move can also choose not to capture, so the static evaluation is a lower bound.
+		 *  - delta pruning: captures that can't raise alpha even with a safety margin are skipped.
+		 *  - the moves are ordered by their MVV-LVA scores.
+		 * It goes at most maxQuiescenceDepth plies deep, then evaluates anyway.
+		 * Only captures and promotions are generated, and the mobility of the stand pat is approximated: the moves
+		 * of each side are counted the first time it is to move, and that count is passed down the capture sequence.
+		 * - ply: distance from the root, for the mate scores.
+		 * - mobility, enemyMobility: pseudo legal move counts of the side to move and the other side, unknownMobility if
+		 *   they were not counted yet.
+		 */
+		int quiescence(int alpha, int beta, unsigned int ply, unsigned int quiescenceDepth, unsigned int mobility, unsigned int enemyMobility);
+
+		/*
+		 * Counts a node and every few nodes checks if the search must stop. The main worker
+		 * also checks the time and node budgets here, but the first iteration is never aborted, so there is
+		 * always a move to play.
+		 */
+		void countNode();
+	};
+}
+
+#endif /* SRC_ENGINE_SEARCH_WORKER_H_ */
@@ -0,0 +1,64 @@
+/*
+ * thread_pool.cpp
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#include "thread_pool.h"
+
+namespace tchess
+{
+	thread_pool::thread_pool(unsigned int threadCount) : taskNumber(0), runningThreads(0), quit(false) {
+		for(unsigned int i = 0; i < threadCount; ++i) {
+			threads.emplace_back(&thread_pool::threadLoop, this, i);
+		}
+	}
+
+	thread_pool::~thread_pool() {
+		wait();
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			quit = true;
+		}
+		taskStarted.notify_all();
+		for(std::thread& t : threads) {
+			t.join();
+		}
+	}
+
+	void thread_pool::start(const std::function<void(unsigned int)>& newTask) {
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			task = newTask;
+			runningThreads = (unsigned int)threads.size();
+			++taskNumber;
+		}
+		taskStarted.notify_all();
+	}
+
+	void thread_pool::wait() {
+		std::unique_lock<std::mutex> lock(mutex);
+		taskFinished.wait(lock, [this] { return runningThreads == 0; });
+	}
+
+	void thread_pool::threadLoop(unsigned int index) {
+		unsigned long long lastTask = 0;
+		while(true) {
+			std::function<void(unsigned int)> currentTask;
+			{
+				std::unique_lock<std::mutex> lock(mutex);
+				taskStarted.wait(lock, [&] { return quit || taskNumber != lastTask; });
+				if(quit) return;
+				lastTask = taskNumber;
+				currentTask = task;
+			}
+			currentTask(index);
+			{
+				std::lock_guard<std::mutex> lock(mutex);
+				--runningThreads;
+			}
+			taskFinished.notify_all();
+		}
+	}
+}
@@ -0,0 +1,80 @@
+/*
+ * thread_pool.h
+ *
+ * Threads that are started once and then run the same task again and again, used by the
+ * engine for the helper threads of the parallel search.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#ifndef SRC_ENGINE_THREAD_POOL_H_
+#define SRC_ENGINE_THREAD_POOL_H_
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+
+namespace tchess
+{
+	/*
+	 * Fixed amount of threads that wait for a task. When a task is started, every thread
+	 * runs it once, with its own index as the parameter.
+	 */
+	class thread_pool {
+
+		//The waiting threads.
+		std::vector<std::thread> threads;
+
+		//Guards all the other members.
+		std::mutex mutex;
+
+		//Signaled when a task is started or the pool is destroyed.
+		std::condition_variable taskStarted;
+
+		//Signaled when a thread finished the task.
+		std::condition_variable taskFinished;
+
+		//The current task, called with the index of the thread.
+		std::function<void(unsigned int)> task;
+
+		//Increased with each started task, so that the threads know when there is a new one.
+		unsigned long long taskNumber;
+
+		//Amount of threads that are still running the current task.
+		unsigned int runningThreads;
+
+		//Set when the pool is destroyed.
+		bool quit;
+
+		//Loop of the threads: wait for a task, run it, report that it finished.
+		void threadLoop(unsigned int index);
+
+	public:
+		thread_pool(unsigned int threadCount);
+
+		//Waits for the current task to finish, then stops the threads.
+		~thread_pool();
+
+		thread_pool(const thread_pool&) = delete;
+
+		thread_pool& operator=(const thread_pool&) = delete;
+
+		/*
+		 * Starts the task on all threads and returns immediately. The previous task
+		 * must have finished (see wait).
+		 */
+		void start(const std::function<void(unsigned int)>& task);
+
+		//Waits until all threads finished the current task.
+		void wait();
+
+		inline unsigned int size() const {
+			return (unsigned int)threads.size();
+		}
+	};
+}
+
+#endif /* SRC_ENGINE_THREAD_POOL_H_ */
@@ -5,28 +5,30 @@
  *      Author: Gspr Tams
  */
 
-#define TRANSP_TABLE_SIZE 256000000 //in bytes
+#include <stdexcept>
+#include <cstdint>
+#include <cstdlib>
 
 #include "transposition_table.h"
 
+#if defined(_WIN32)
+#include <windows.h> //VirtualAlloc for the table memory, like mmap below
+#elif defined(__linux__)
+#include <sys/mman.h>
+#endif
+
 namespace tchess
 {
 	uint64 createZobrishHash(const chessboard& board, const game_information& info) {
 		uint64 boardKey = 0;
-		unsigned int rank = 0, file = 0;
 		//iterate board and find pieces
 		for(unsigned int square = 0; square < 64; ++square) {
 			if(board[square] != 0) { //piece found
-				unsigned int polyPiece = polyPieceCode(board[square]); //get polyglot piece code
-				//find rank and board of square
-				file = square % 8;
-				rank = 7 - square / 8;
-				//"add" piece to polyglot key
-				boardKey ^= Random64[(64 * polyPiece) + (8 * rank) + file];
+				boardKey ^= zobristPieceKey(board[square], square);
 			}
 		}
 		//add castling rights to board key
-		int offset = 768;
+		int offset = castleKeyOffset;
 		if(info.getKingsideCastleRights(white)) {
 			boardKey ^= Random64[offset];
 		}
@@ -40,7 +42,7 @@ namespace tchess
 			boardKey ^= Random64[offset + 3];
 		}
 		//add en passant sqaure to board key
-		offset = 772;
+		offset = enPassantKeyOffset;
 		int whiteEnPassantSquare = info.getEnPassantSquare(white);
 		int blackEnPassantSquare = info.getEnPassantSquare(black);
 		int enPassantSquare = noEnPassant;
@@ -54,21 +56,86 @@ namespace tchess
 			boardKey ^= Random64[offset + enPassantFile];
 		}
 		//add side to move to key
-		offset = 780;
+		offset = sideKeyOffset;
 		if(info.getSideToMove() == black) {
 			boardKey ^= Random64[offset];
 		}
 		return boardKey;
 	}
 
+	void verifyZobristHash(uint64 key, const chessboard& board, const game_information& info) {
+		if(key != createZobrishHash(board, info)) {
+			throw std::runtime_error("Incremental zobrist hash differs from the recomputed one on this board:\n" + board.to_string());
+		}
+	}
+
 	const unsigned short exact = 1;
 	const unsigned short upperBound = 2;
 	const unsigned short lowerBound = 3;
 	const unsigned short uninitialized = 4;
 
-	const transposition_entry EMPTY_ENTRY = transposition_entry();
+	const unsigned int def_transposition_table_size = 256;
+
+#ifdef __linux__
+	//Size of a huge page on Linux.
+	static const size_t hugePageSize = 2 * 1024 * 1024;
+#endif
+
+	transposition_table::transposition_table(unsigned int megabytes, bool hugePages) : generation(0) {
+		//largest power of 2 amount of buckets that fits
+		size_t maxBytes = (size_t)megabytes * 1024 * 1024;
+		size_t bucketCount = 1;
+		while(2 * bucketCount * sizeof(transposition_bucket) <= maxBytes) {
+			bucketCount *= 2;
+		}
+		mask = bucketCount - 1;
+		memorySize = bucketCount * sizeof(transposition_bucket);
+		//the pages are zeroed by the system when they are first used, and a zero entry is empty
+#if defined(_WIN32)
+		memory = VirtualAlloc(NULL, memorySize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+		if(memory == NULL) {
+			throw std::runtime_error("Can't allocate the transposition table!");
+		}
+		buckets = static_cast<transposition_bucket*>(memory);
+#elif defined(__linux__)
+		memory = MAP_FAILED;
+#ifdef MAP_HUGETLB
+		if(hugePages) { //explicit huge pages, only available if the system has some reserved
+			size_t hugeSize = (memorySize + hugePageSize - 1) / hugePageSize * hugePageSize;
+			memory = mmap(NULL, hugeSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+			if(memory != MAP_FAILED) memorySize = hugeSize;
+		}
+#endif
+		if(memory == MAP_FAILED) {
+			memory = mmap(NULL, memorySize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+			if(memory == MAP_FAILED) {
+				throw std::runtime_error("Can't allocate the transposition table!");
+			}
+#ifdef MADV_HUGEPAGE
+			if(hugePages) madvise(memory, memorySize, MADV_HUGEPAGE); //ask for transparent huge pages
+#endif
+		}
+		buckets = static_cast<transposition_bucket*>(memory);
+#else
+		//calloc of a large block usually gets fresh pages from the system as well
+		memory = std::calloc(memorySize + alignof(transposition_bucket), 1);
+		if(memory == NULL) {
+			throw std::runtime_error("Can't allocate the transposition table!");
+		}
+		uintptr_t address = reinterpret_cast<uintptr_t>(memory);
+		buckets = reinterpret_cast<transposition_bucket*>((address + alignof(transposition_bucket) - 1) / alignof(transposition_bucket) * alignof(transposition_bucket));
+#endif
+	}
 
-	const unsigned int def_transposition_table_size = TRANSP_TABLE_SIZE / sizeof(transposition_entry);
+	transposition_table::~transposition_table() {
+#if defined(_WIN32)
+		VirtualFree(memory, 0, MEM_RELEASE);
+#elif defined(__linux__)
+		munmap(memory, memorySize);
+#else
+		std::free(memory);
+#endif
+	}
 }
 
 
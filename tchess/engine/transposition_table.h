@@ -10,16 +10,25 @@
 
 #include <utility>
 #include <array>
+#include <atomic>
+#include <cstddef>
 
 #include "polyglot.h" //<- for the 781 random numbers and uint typedef
 
 namespace tchess
 {
 	/*
-	 * Creates a 64 bit hash from a position.
+	 * Creates a 64 bit hash from a position, from scratch. The search uses the incrementally
+	 * updated positionHashKey instead, this is used to verify it.
 	 */
 	uint64 createZobrishHash(const chessboard& board, const game_information& info);
 
+	/*
+	 * Debug check that compares an incrementally updated hash key with the one created from scratch,
+	 * and throws an exception if they differ.
+	 */
+	void verifyZobristHash(uint64 key, const chessboard& board, const game_information& info);
+
 	/*
 	 * Constants for the 3 types of entries in the transposition table. Extra type is
 	 * for
@@ -27,13 +36,11 @@ namespace tchess
 	extern const unsigned short exact, upperBound, lowerBound, uninitialized;
 
 	/*
-	 * Represents an entry in the transposition table.
+	 * Represents an entry in the transposition table, as the search uses it. The table
+	 * stores it packed into 64 bits (see packed_entry).
 	 */
 	struct transposition_entry {
 
-		//Hash of this entry.
-		uint64 hashKey;
-
 		//One of the exact, upperBound, lowerBound constants (or the uninitialized).
 		unsigned short entryType;
 
@@ -42,16 +49,11 @@ namespace tchess
 
 		/*
 		 * The score that was recorded in the position. How this
-		 * is interpreted depends in the entry type.
+		 * is interpreted depends in the entry type. Mate scores are stored relative to
+		 * this position, not to the root of the search.
 		 */
 		int score;
 
-		/*
-		 * This flag determines how the entry can be replaced. If the entry
-		 * is useful it will not be replaced.
-		 */
-		bool usefulEntry;
-
 		/*
 		 * The best move at this position.
 		 */
@@ -60,122 +62,215 @@ namespace tchess
 		/*
 		 * Creates an uninitialized entry.
 		 */
-		transposition_entry() : hashKey(0), entryType(uninitialized), depth(0), score(0), usefulEntry(false), bestMove(NULLMOVE) {}
+		transposition_entry() : entryType(uninitialized), depth(0), score(0), bestMove(NULLMOVE) {}
 
 		//constructor from values
-		transposition_entry(uint64 hashKey, unsigned short entryType, unsigned int depth, int score, bool useful, const move& m)
-			: hashKey(hashKey), entryType(entryType), depth(depth), score(score), usefulEntry(useful), bestMove(m) {}
-
-		//Copy constructor.
-		transposition_entry(const transposition_entry& other) : hashKey(other.hashKey), entryType(other.entryType), depth(other.depth),
-				score(other.score), usefulEntry(other.usefulEntry), bestMove(other.bestMove) {}
-
-		//Assignment operator.
-		void operator=(const transposition_entry& other) {
-			hashKey = other.hashKey;
-			entryType = other.entryType;
-			depth = other.depth;
-			score = other.score;
-			usefulEntry = other.usefulEntry;
-			bestMove = other.bestMove;
-		}
+		transposition_entry(unsigned short entryType, unsigned int depth, int score, const move& m)
+			: entryType(entryType), depth(depth), score(score), bestMove(m) {}
+	};
 
-		bool operator==(const transposition_entry& other) {
-			return hashKey == other.hashKey && entryType == other.entryType && depth == other.depth &&
-					score == other.score && usefulEntry == other.usefulEntry && bestMove == other.bestMove;
-		}
+	/*
+	 * One entry of the table in 16 bytes. The data word has the entry packed into it:
+	 *  - bits 0-15: best move, in its 16 bit form
+	 *  - bits 16-47: score
+	 *  - bits 48-55: depth
+	 *  - bits 56-57: entry type, 0 means the entry is empty
+	 *  - bits 58-63: generation, the search that stored or last used the entry
+	 * The key word is the hash key XOR the data word. Threads read and write the two words
+	 * without locking, and a reader only accepts the entry if key word XOR data word gives back its key.
+	 * If the two words were written by different threads, this check fails (with a very high probability).
+	 */
+	struct packed_entry {
 
-		bool operator!=(const transposition_entry& other) {
-			return !(*this == other);
-		}
+		std::atomic<uint64> keyXorData;
+
+		std::atomic<uint64> data;
 	};
 
+	//Amount of entries in a bucket.
+	const unsigned int bucketSize = 4;
+
 	/*
-	 * A constant entry that is used for "uninitialized" entries.
+	 * The entries that belong to the same index, they fill exactly one cache line.
 	 */
-	extern const transposition_entry EMPTY_ENTRY;
+	struct alignas(64) transposition_bucket {
+		packed_entry entries[bucketSize];
+	};
 
 	/*
-	 * The amount of entries in the transposition table. Determined by how many entries can
-	 * fit in 256 MB.
+	 * Default size of the transposition table in megabytes.
 	 */
 	extern const unsigned int def_transposition_table_size;
 
 	/*
 	 * Transposition table implementation, that is a fixed size hash map. Sadly unordered_map is
 	 * not good, because it can't have a fixed size.
-	 * - Key: must be a type for which mod operator is defined.
+	 *
+	 * The amount of buckets is a power of 2, and a key is mapped to a bucket by masking its low bits. The key
+	 * can be stored in any of the 4 entries of the bucket. The table is shared by the search threads without
+	 * locking, see packed_entry.
+	 *
+	 * The memory is taken directly from the operating system, which gives zeroed (empty) pages
+	 * on first touch, so creating even a large table is instant.
 	 */
 	class transposition_table {
 
+		//Amount of buckets - 1, the buckets index mask.
+		uint64 mask;
+
+		//Memory allocated for the table, the buckets are in it aligned to cache lines.
+		void* memory;
+
+		//Size of the allocated memory in bytes.
+		size_t memorySize;
+
 		/*
-		 * Transposition table size.
+		 * Bucket array with fixed size. Each entry starts empty.
 		 */
-		const unsigned int size;
+		transposition_bucket* buckets;
 
 		/*
-		 * Entry array with fixed size. Each entry is "initialized" to have uninitialized type.
+		 * Generation of the current search, increased when a new search starts. Entries of
+		 * older generations are replaced first. Only 6 bits are used, it wraps around.
 		 */
-		std::vector<transposition_entry> entries;
+		unsigned int generation;
 
-		unsigned int tt_lookup_count;
+	public:
+		/*
+		 * Create an "empty" transposition table that takes at most the given megabytes. The memory is
+		 * rounded down to a power of 2 amount of buckets. With the huge pages parameter the table is
+		 * backed by 2 MB pages if the system supports it (only on Linux, explicit huge pages if some are
+		 * reserved, otherwise transparent huge pages).
+		 */
+		transposition_table(unsigned int megabytes, bool hugePages);
 
-		unsigned int tt_put_count;
+		~transposition_table();
+
+		transposition_table(const transposition_table&) = delete;
+
+		transposition_table& operator=(const transposition_table&) = delete;
 
-	public:
 		/*
-		 * Create an "empty" transposition table. It will have all entries set to EMPTY_ENTRY.
+		 * Looks up the entry of the given key in its bucket. If it is found, it is copied into
+		 * the 'found' parameter and true is returned.
 		 */
-		transposition_table(unsigned int size) : size(size), entries(size, EMPTY_ENTRY), tt_lookup_count(0), tt_put_count(0) {}
+		bool probe(uint64 key, transposition_entry& found) {
+			transposition_bucket& bucket = buckets[key & mask];
+			for(packed_entry& e : bucket.entries) {
+				uint64 data = e.data.load(std::memory_order_relaxed);
+				if(data != 0 && (e.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {
+					found = unpackEntry(data);
+					return true;
+				}
+			}
+			return false;
+		}
 
 		/*
-		 * Returns the entry for the given key. First the index of the key
-		 * is created using the modulo operator.
-		 * To see if there is an actual entry, the result must be compared with
-		 * Value::EMPTY_ENTRY.
+		 * Moves the entry of the key to the current generation, so that it is not replaced during this search. Called
+		 * when a probed entry was deep enough to be used.
 		 */
-		transposition_entry& find(uint64 key) {
-			++tt_lookup_count;
-			return entries[key % size];
+		void markUseful(uint64 key) {
+			transposition_bucket& bucket = buckets[key & mask];
+			for(packed_entry& e : bucket.entries) {
+				uint64 data = e.data.load(std::memory_order_relaxed);
+				if(data != 0 && (e.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {
+					if(entryGeneration(data) == generation) return; //already current
+					data = (data & ~generationMask) | ((uint64)generation << 58);
+					e.data.store(data, std::memory_order_relaxed);
+					e.keyXorData.store(key ^ data, std::memory_order_relaxed);
+					return;
+				}
+			}
 		}
 
 		/*
-		 * Adds a new entry to the table, according to the replacement
-		 * strategy.
+		 * Adds a new entry to the table, according to the replacement strategy. An empty entry or the
+		 * entry of the same key is used if there is one in the bucket, otherwise the least valuable entry:
+		 * the one with the smallest depth, where each search since the entry was last used counts as 4 less depth.
 		 */
-		void put(uint64 key, transposition_entry entry) {
-			auto mod = key % size;
-			if(replaceOldEntry(entries[mod], entry)) {
-				++tt_put_count;
+		void put(uint64 key, const transposition_entry& entry) {
+			transposition_bucket& bucket = buckets[key & mask];
+			packed_entry* replaced = nullptr;
+			uint64 replacedData = 0;
+			for(packed_entry& e : bucket.entries) {
+				uint64 data = e.data.load(std::memory_order_relaxed);
+				if(data == 0 || (e.keyXorData.load(std::memory_order_relaxed) ^ data) == key) {
+					replaced = &e;
+					replacedData = data;
+					break;
+				}
+				if(replaced == nullptr || entryValue(data, generation) < entryValue(replacedData, generation)) {
+					replaced = &e;
+					replacedData = data;
+				}
+			}
+			if(replacedData == 0 || replaceOldEntry(replacedData, entry, generation)) {
 				//replace the old entry
-				entries[mod] = entry;
+				uint64 data = packEntry(entry) | ((uint64)generation << 58);
+				replaced->data.store(data, std::memory_order_relaxed);
+				replaced->keyXorData.store(key ^ data, std::memory_order_relaxed);
 			}
 		}
 
 		/*
-		 * Marks all entries as "useless". This is called between each move search, to
-		 * allow the replacement of old entries.
+		 * Starts a new generation. This is called before each move search, so that the entries of
+		 * the earlier searches can be replaced.
 		 */
-		void invalidateEntries() {
-			for(unsigned int i = 0; i < size; ++i) {
-				entries[i].usefulEntry = false;
-			}
+		void newSearch() {
+			generation = (generation + 1) & 63;
 		}
 
-		void printDebug() const {
-			std::cout << "TT lookup used: " << tt_lookup_count << "\n" <<
-					"TT put used: " << tt_put_count << std::endl;
+		//Amount of entries the table can hold.
+		inline uint64 capacity() const {
+			return (mask + 1) * bucketSize;
 		}
 
 	private:
 
+		//The generation bits in the data word.
+		static const uint64 generationMask = 63ULL << 58;
+
+		//Generation of a data word.
+		static inline unsigned int entryGeneration(uint64 data) {
+			return (unsigned int)(data >> 58);
+		}
+
+		//How many searches ago the entry was stored or last used.
+		static inline unsigned int entryAge(uint64 data, unsigned int generation) {
+			return (generation - entryGeneration(data)) & 63;
+		}
+
+		//Packs an entry into a data word, without the generation.
+		static inline uint64 packEntry(const transposition_entry& entry) {
+			return (uint64)entry.bestMove.getData() | ((uint64)(unsigned int)entry.score << 16) |
+				((uint64)(entry.depth & 0xFF) << 48) | ((uint64)entry.entryType << 56);
+		}
+
+		//Unpacks a data word.
+		static inline transposition_entry unpackEntry(uint64 data) {
+			return transposition_entry((unsigned short)((data >> 56) & 3), (unsigned int)((data >> 48) & 0xFF),
+				(int)(unsigned int)(data >> 16), move::fromData((unsigned short)data));
+		}
+
+		/*
+		 * How valuable an entry is to keep, used to select which entry of a full bucket is replaced. Deeper
+		 * entries are more valuable, and an entry loses 4 depth for each search since it was last used.
+		 */
+		static inline int entryValue(uint64 data, unsigned int generation) {
+			return (int)((data >> 48) & 0xFF) - 4 * (int)entryAge(data, generation);
+		}
+
 		/*
-		 * This function determines the replacement strategy of the transposition table.
+		 * This function determines the replacement strategy of the transposition table: entries of
+		 * earlier searches are always replaced, entries of this search only by deeper or exact entries.
 		 */
-		inline bool replaceOldEntry(transposition_entry oldEntry, transposition_entry newEntry) {
-			if(oldEntry.entryType == exact && newEntry.entryType != exact) return false; //never replace exact with not exact
-			if(oldEntry.entryType != exact && newEntry.entryType == exact) return true; //always replace not exact with exact
-			return !oldEntry.usefulEntry; //if the old entry was used in lookup recently, then dont replace
+		static inline bool replaceOldEntry(uint64 oldData, const transposition_entry& newEntry, unsigned int generation) {
+			if(entryAge(oldData, generation) > 0) return true; //not used in this search
+			unsigned short oldType = (unsigned short)((oldData >> 56) & 3);
+			if(oldType != exact && newEntry.entryType == exact) return true; //always replace not exact with exact
+			if(oldType == exact && newEntry.entryType != exact) return false; //never replace exact with not exact
+			return newEntry.depth >= ((oldData >> 48) & 0xFF);
 		}
 	};
 }
@@ -6,6 +6,7 @@
  */
 
 #include "game.h"
+#include "image_utils.h"
 
 #include "human/human_player_gui.h"
 #include "engine/engine.h"
@@ -202,7 +203,7 @@ namespace tchess
 			//appears to be capture
 			if(!m.isPromotion()) {
 				//not a promotion
-				m = move(m.getFromSquare(), m.getToSquare(), capture, 0);
+				m = move(m.getFromSquare(), m.getToSquare(), capture);
 			} else {
 				//promotion capture, replace promotion with promotion capture
 				unsigned int promTo = m.promotedTo();
@@ -216,12 +217,12 @@ namespace tchess
 				} else {
 					promCapTo = knightPromotionCap;
 				}
-				m = move(m.getFromSquare(), m.getToSquare(), promCapTo, 0);
+				m = move(m.getFromSquare(), m.getToSquare(), promCapTo);
 			}
 		}
 		else if ((piece == -1 || piece == 1) && atDest == 0 && fileFrom != fileTo) {
 			//appears to be en passant: pawn move to empty square CHANGING files
-			m = move(m.getFromSquare(), m.getToSquare(), enPassantCapture, 0);
+			m = move(m.getFromSquare(), m.getToSquare(), enPassantCapture);
 		}
 	}
 
@@ -251,22 +252,11 @@ namespace tchess
 			updateGameInformation(board, m, info);
 			/*
 			 * Check if the game has ended: checkmate, stalemate, repetition, etc.
-			 * For this, all legal moves of the side to move is needed.
+			 * For this, it is enough to know if the side to move has any legal move.
 			 * Also need to know is the side to move is in check.
 			 */
 			bool check = isAttacked(board, side, board.getKingSquare(1 - side)), checkmate = false, stalemate = false;
-			generator.generatePseudoLegalMoves(1 - side, pseudoLegalMoves); //all pseudo legal moves of the side to move
-			unsigned int legalMoveCount = 0;
-			for (const move& plMove : pseudoLegalMoves) {
-				move_legality_result legRes = isValidMove(plMove, pseudoLegalMoves); //this made the move on the board!!!
-				if (legRes.isLegal()) { //found at least 1 legal move, cant be stalemate, checkmate
-					++legalMoveCount;
-					board.unmakeMove(plMove, 1 - side, legRes.getCapturedPiece()); //unmake tested move
-					break;
-				}
-				board.unmakeMove(plMove, 1 - side, legRes.getCapturedPiece()); //unmake tested move
-			}
-			if (legalMoveCount == 0) { //no legal moves, must be checkmate or stalemate
+			if (!generator.hasAnyLegalMove(1 - side)) { //no legal moves, must be checkmate or stalemate
 				if (check) {
 					checkmate = true;
 				}
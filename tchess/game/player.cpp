@@ -77,7 +77,7 @@ tchess::saved_game tchess::readSaveFromFile(CString p)
 	input.close();
 	if (reason == "Resignation") {
 		//if the player resigned in the saved game, then the last move is resignation
-		moves.push_back(move(0, 0, resignMove, 0));
+		moves.push_back(move(0, 0, resignMove));
 	}
 	//move extra info will be rebuilt the the game controller anyways when playing out the moves
 	return saved_game(whitePlayer, blackPlayer, result, reason,
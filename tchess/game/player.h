@@ -84,7 +84,7 @@ namespace tchess
 		*/
 		move makeMove(game* gameController) {
 			//should not happen
-			if (moveStack.empty()) return move(0, 0, resignMove, 0);
+			if (moveStack.empty()) return move(0, 0, resignMove);
 			move m = moveStack.top();
 			moveStack.pop();
 			return m;
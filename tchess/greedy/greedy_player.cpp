@@ -12,13 +12,6 @@
 
 namespace tchess
 {
-	std::vector<move> createEnemyMoves(unsigned int enemySide, const chessboard& board, const game_information& info) {
-		std::vector<move> enemyMoves;
-		move_generator generator(board, info);
-		generator.generatePseudoLegalMoves(enemySide, enemyMoves);
-		return enemyMoves;
-	}
-
 	move greedy_player::makeMove(game* gameController) {
 		const std::vector<move>& gameMoves = gameController->getMoves();
 		if(gameMoves.size() > 0) {
@@ -28,28 +21,19 @@ namespace tchess
 		}
 		std::vector<move> moves;
 		move_generator generator(board, info);
-		generator.generatePseudoLegalMoves(side, moves); //generate all pseudo legal moves
-		auto legalCheck = [&](const move& m) { return !(isLegalMove(m, board, info)); }; //used later
-		auto legalEnd = std::remove_if(moves.begin(), moves.end(), legalCheck);
+		generator.generateLegalMoves(side, moves); //generate all legal moves
 
 		std::cout << "Greedy board before move:\n" << board.to_string() << std::endl;
 		move bestMove; //stores current best move
 		int bestEvaluation = WORST_VALUE;
 		//iterate all legal moves to greedily find best move
-		for(auto it = moves.begin(); it != legalEnd; ++it) {
+		for(auto it = moves.begin(); it != moves.end(); ++it) {
 			move _move = *it;
 			int capturedPiece = board.makeMove(_move, side);
 			game_information infoAfterMove = info; //copy game info to not modify the original
 			updateGameInformation(board, _move, infoAfterMove);
 			//the move is legal, and it is made on the board, now evaluate
-			std::vector<move> enemyMoves = createEnemyMoves(1-side, board, infoAfterMove);
-			bool legalEnemyMoves = false;
-			for(const move& enemyMove: enemyMoves) {
-				if(isLegalMove(enemyMove, board, infoAfterMove)) {
-					legalEnemyMoves = true;
-					break;
-				}
-			}
+			bool legalEnemyMoves = move_generator(board, infoAfterMove).hasAnyLegalMove(1-side);
 			special_board sb = isSpecialBoard(1-side, board, legalEnemyMoves, 1);
 			int evaluation = 0;
 			if(sb.special) { //no need for static evaluation
@@ -1,5 +1,6 @@
 #include <string>
 #include <fstream>
+#include <cstdlib>
 
 #include "image_utils.h"
 
@@ -66,4 +67,67 @@ namespace tchess
 		//load empty + black pieces on dark background
 		fillArrayWithImages("dark", "black", dark_black_images);
 	}
+
+	//Helper method that checks 
+	bool isLightSquare(unsigned int square) {
+		//detemine rank and file
+		unsigned int rank = square / 8;
+		unsigned int file = square % 8;
+		if (rank % 2 == 0) {
+			if (file % 2 == 0) {
+				return true;
+			}
+			else {
+				return false;
+			}
+		}
+		else {
+			if (file % 2 == 0) {
+				return false;
+			}
+			else {
+				return true;
+			}
+		}
+	}
+
+	void drawBoard(const chessboard& board, std::vector<CPictureCtrl>& squareControls)
+	{
+		for (unsigned int square = 0; square < 64; ++square) {
+			if (isLightSquare(square)) {
+				//we are on a light square
+				if (board[square] > 0) {
+					//white piece
+					unsigned int piece = board[square];
+					squareControls[square].Load(light_white_images[piece].data(), light_white_images[piece].size());
+				}
+				else if (board[square] < 0) {
+					//black piece
+					unsigned int piece = std::abs(board[square]);
+					squareControls[square].Load(light_black_images[piece].data(), light_black_images[piece].size());
+				}
+				else {
+					//empty square
+					squareControls[square].Load(light_white_images[empty].data(), light_white_images[empty].size());
+				}
+			}
+			else {
+				//we are on a dark square
+				if (board[square] > 0) {
+					//white piece
+					unsigned int piece = board[square];
+					squareControls[square].Load(dark_white_images[piece].data(), dark_white_images[piece].size());
+				}
+				else if (board[square] < 0) {
+					//black piece
+					unsigned int piece = std::abs(board[square]);
+					squareControls[square].Load(dark_black_images[piece].data(), dark_black_images[piece].size());
+				}
+				else {
+					//empty square
+					squareControls[square].Load(dark_white_images[empty].data(), dark_white_images[empty].size());
+				}
+			}
+		}
+	}
 }
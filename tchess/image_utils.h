@@ -9,6 +9,9 @@
 #include <array>
 #include <vector>
 
+#include "PictureCtrl.h"
+#include "board/board.h"
+
 #define NUM_IMAGES 7 //6 pieces and an empty square
 
 namespace tchess
@@ -29,4 +32,9 @@ namespace tchess
 
 	//Loads chess related images into the vectors.
 	void loadChessImages();
+
+	/*
+	 * Draws the given board in the GUI. The vector of picture controls is used to access the rectangles where the squares will be drawn.
+	 */
+	void drawBoard(const chessboard& board, std::vector<CPictureCtrl>& squareControls);
 }
\ No newline at end of file
@@ -0,0 +1,198 @@
+/*
+ * perft.cpp
+ *
+ * Command line perft tool: counts the leaf nodes of the move generation tree to a depth. The counts
+ * of well known positions are published, so this verifies the move generator, and the nodes per second
+ * are a benchmark for it. Only uses the board sources, so it builds without MFC (see CMakeLists.txt).
+ *
+ * Usage:
+ *  perft perft <depth> [fen]   perft of the position (start position if there is no fen), for each depth up to the given one
+ *  perft divide <depth> [fen]  perft of the position after each legal move
+ *  perft suite                 runs the standard positions and compares with the known counts
+ * Add --bulk to count the legal moves at depth 1 instead of making them.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <chrono>
+#include <cctype>
+#include <cstdlib>
+#include <stdexcept>
+
+#include "board/board.h"
+#include "board/position.h"
+
+namespace tchess
+{
+	//The start position.
+	const std::string startFen = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1";
+
+	//A position with a known perft count.
+	struct perft_case {
+		std::string fen;
+		unsigned int depth;
+		unsigned long long nodes;
+	};
+
+	/*
+	 * Standard perft positions (chessprogramming.org) and some positions for the special cases: en passant
+	 * that would expose the king, castling rights, promotions and discovered checks.
+	 */
+	const std::vector<perft_case> perftSuite = {
+		{ startFen, 5, 4865609ULL },
+		{ "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1", 4, 4085603ULL }, //"kiwipete"
+		{ "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1", 6, 11030083ULL },
+		{ "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1", 5, 15833292ULL },
+		{ "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8", 4, 2103487ULL },
+		{ "r4rk1/1pp1qppp/p1np1n2/2b1p1B1/2B1P1b1/P1NP1N2/1PP1QPPP/R4RK1 w - - 0 10", 4, 3894594ULL },
+		{ "3k4/3p4/8/K1P4r/8/8/8/8 b - - 0 1", 6, 1134888ULL },
+		{ "8/8/1k6/2b5/2pP4/8/5K2/8 b - d3 0 1", 6, 1440467ULL },
+		{ "5k2/8/8/8/8/8/8/4K2R w K - 0 1", 6, 661072ULL },
+		{ "8/k1P5/8/1K6/8/8/8/8 w - - 0 1", 7, 567584ULL },
+		{ "8/8/2k5/5q2/5n2/8/5K2/8 b - - 0 1", 4, 23527ULL }
+	};
+
+	//Name of a move in coordinate notation, for example e2e4 or a7a8q.
+	std::string moveName(const move& m) {
+		std::string name = createSquareName(m.getFromSquare()) + createSquareName(m.getToSquare());
+		if(m.isPromotion()) name += (char)std::tolower(pieceNameFromCode(m.promotedTo()));
+		return name;
+	}
+
+	/*
+	 * Counts the leaf nodes to the depth. In bulk mode the moves on the last level are only
+	 * counted, not made.
+	 */
+	unsigned long long perft(position& pos, unsigned int depth, bool bulk) {
+		if(depth == 0) return 1;
+		move_list moves;
+		move_generator(pos.getBoard(), pos.getInfo()).generateLegalMoves(pos.getSideToMove(), moves);
+		if(bulk && depth == 1) return moves.size();
+		unsigned long long nodes = 0;
+		for(const move& m: moves) {
+			pos.makeMove(m);
+			nodes += perft(pos, depth - 1, bulk);
+			pos.unmakeMove();
+		}
+		return nodes;
+	}
+
+	//Seconds since the given time point.
+	double secondsSince(std::chrono::steady_clock::time_point start) {
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	unsigned long long nodesPerSecond(unsigned long long nodes, double seconds) {
+		return seconds > 0 ? (unsigned long long)(nodes / seconds) : 0;
+	}
+
+	//Perft for each depth up to the given one.
+	void runPerft(position& pos, unsigned int depth, bool bulk) {
+		for(unsigned int d = 1; d <= depth; ++d) {
+			auto start = std::chrono::steady_clock::now();
+			unsigned long long nodes = perft(pos, d, bulk);
+			double seconds = secondsSince(start);
+			std::cout << "perft(" << d << ") = " << nodes << "  " << seconds << " s  " << nodesPerSecond(nodes, seconds) << " nps" << std::endl;
+		}
+	}
+
+	//Perft of the position after each legal move, useful to find which move is counted wrong.
+	void runDivide(position& pos, unsigned int depth, bool bulk) {
+		if(depth == 0) throw std::runtime_error("Depth of divide must be at least 1!");
+		move_list moves;
+		move_generator(pos.getBoard(), pos.getInfo()).generateLegalMoves(pos.getSideToMove(), moves);
+		unsigned long long total = 0;
+		auto start = std::chrono::steady_clock::now();
+		for(const move& m: moves) {
+			pos.makeMove(m);
+			unsigned long long nodes = perft(pos, depth - 1, bulk);
+			pos.unmakeMove();
+			std::cout << moveName(m) << ": " << nodes << std::endl;
+			total += nodes;
+		}
+		double seconds = secondsSince(start);
+		std::cout << "moves: " << moves.size() << ", nodes: " << total << "  " << seconds << " s  " << nodesPerSecond(total, seconds) << " nps" << std::endl;
+	}
+
+	//Runs the perft suite, returns if all counts were correct.
+	bool runSuite(bool bulk) {
+		bool allCorrect = true;
+		unsigned long long totalNodes = 0;
+		double totalSeconds = 0;
+		for(const perft_case& c: perftSuite) {
+			chessboard board;
+			game_information info;
+			loadFen(c.fen, board, info);
+			position pos;
+			pos.set(board, info);
+			auto start = std::chrono::steady_clock::now();
+			unsigned long long nodes = perft(pos, c.depth, bulk);
+			double seconds = secondsSince(start);
+			totalNodes += nodes;
+			totalSeconds += seconds;
+			bool correct = nodes == c.nodes;
+			allCorrect = allCorrect && correct;
+			std::cout << (correct ? "ok     " : "FAILED ") << c.fen << "  depth " << c.depth << ": " << nodes;
+			if(!correct) std::cout << " (expected " << c.nodes << ")";
+			std::cout << "  " << seconds << " s  " << nodesPerSecond(nodes, seconds) << " nps" << std::endl;
+		}
+		std::cout << (allCorrect ? "All counts are correct" : "Some counts are WRONG") << ", " << totalNodes << " nodes in "
+				<< totalSeconds << " s, " << nodesPerSecond(totalNodes, totalSeconds) << " nps" << std::endl;
+		return allCorrect;
+	}
+
+	void printUsage() {
+		std::cout << "Usage:\n"
+				<< "  perft perft <depth> [fen]\n"
+				<< "  perft divide <depth> [fen]\n"
+				<< "  perft suite\n"
+				<< "Add --bulk to count the moves of the last depth without making them." << std::endl;
+	}
+}
+
+int main(int argc, char** argv) {
+	using namespace tchess;
+	std::vector<std::string> args;
+	bool bulk = false;
+	for(int i = 1; i < argc; ++i) {
+		std::string arg = argv[i];
+		if(arg == "--bulk") {
+			bulk = true;
+		} else {
+			args.push_back(arg);
+		}
+	}
+	try {
+		if(args.size() == 1 && args[0] == "suite") {
+			return runSuite(bulk) ? 0 : 1;
+		}
+		if(args.size() >= 2 && (args[0] == "perft" || args[0] == "divide")) {
+			unsigned int depth = (unsigned int)std::stoul(args[1]);
+			std::string fen = startFen;
+			if(args.size() > 2) { //the fen is given in one or more arguments
+				fen = args[2];
+				for(size_t i = 3; i < args.size(); ++i) fen += " " + args[i];
+			}
+			chessboard board;
+			game_information info;
+			loadFen(fen, board, info);
+			position pos;
+			pos.set(board, info);
+			if(args[0] == "perft") {
+				runPerft(pos, depth, bulk);
+			} else {
+				runDivide(pos, depth, bulk);
+			}
+			return 0;
+		}
+	} catch(const std::exception& e) {
+		std::cerr << "Error: " << e.what() << std::endl;
+		return 1;
+	}
+	printUsage();
+	return 1;
+}
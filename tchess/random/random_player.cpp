@@ -36,12 +36,9 @@ namespace tchess
 		}
 		std::vector<move> moves;
 		move_generator generator(board, info);
-		generator.generatePseudoLegalMoves(side, moves); //generate all pseudo legal moves
-		//filter out illegal moves
-		auto legalCheck = [&](const move& m) { return !(isLegalMove(m, board, info)); };
-		auto legalEnd = std::remove_if(moves.begin(), moves.end(), legalCheck);
+		generator.generateLegalMoves(side, moves); //generate all legal moves
 
-		move randomMove = *select_randomly(moves.begin(), legalEnd); //select legal move randomly
+		move randomMove = *select_randomly(moves.begin(), moves.end()); //select legal move randomly
 		board.makeMove(randomMove, side); //make own move on own board
 		updateGameInformation(board, randomMove, info);
 		info.setSideToMove(1-side); //the enemy side is to move now
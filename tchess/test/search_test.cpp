@@ -0,0 +1,69 @@
+/*
+ * search_test.cpp
+ *
+ * Tests of the search that run without the GUI (see CMakeLists.txt, they are registered with CTest). Each test
+ * prints if it passed, and the program fails if any of them did not.
+ *
+ *  Created on: 2026. okt. 17.
+ *      Author: Gspr Tams
+ */
+
+#include <iostream>
+#include <string>
+#include <chrono>
+#include <cstdlib>
+
+#include "board/board.h"
+#include "board/evaluation.h"
+#include "engine/search_worker.h"
+
+namespace tchess
+{
+	//Prints the result of a test, returns if it passed.
+	bool report(const std::string& name, bool passed) {
+		std::cout << (passed ? "ok     " : "FAILED ") << name << std::endl;
+		return passed;
+	}
+
+	/*
+	 * The full window is almost as wide as the int range, its width must not overflow into a
+	 * null window.
+	 */
+	bool testPvWindow() {
+		bool passed = isPvWindow(WORST_VALUE, BEST_VALUE) && isPvWindow(-BEST_VALUE, -WORST_VALUE)
+				&& isPvWindow(-100, 100) && !isPvWindow(99, 100) && !isPvWindow(WORST_VALUE, WORST_VALUE + 1);
+		return report("principal variation window", passed);
+	}
+
+	/*
+	 * Searches a mate in 2 with all forward pruning on. The iterations below the aspiration depth use the
+	 * full window, so the principal variation must not be pruned: the mate and its exact distance must be found.
+	 */
+	bool testFullWindowMate() {
+		chessboard board;
+		game_information info;
+		loadFen("r2qkb1r/pp2nppp/3p4/2pNN1B1/2BnP3/3P4/PPP2PPP/R2bK2R w KQkq - 1 1", board, info);
+		transposition_table ttable(16, false);
+		shared_search_state shared;
+		shared.ttable = &ttable;
+		shared.maxDepth = 3;
+		shared.timeBudget = 60000;
+		shared.searchStart = std::chrono::steady_clock::now();
+		shared.nullMovePruning = shared.lateMoveReductions = shared.futilityPruning = shared.reverseFutilityPruning = true;
+		ttable.newSearch();
+		search_worker worker(0, shared, nullptr);
+		worker.setPosition(board, info);
+		worker.search();
+		const move& best = worker.getBestMove();
+		bool passed = worker.getCompletedDepth() == 3 && worker.getBestEvaluation() == BEST_VALUE - 2
+				&& std::abs(board[best.getFromSquare()]) == knight && createSquareName(best.getToSquare()) == "f6";
+		return report("mate in 2 with a full window and forward pruning", passed);
+	}
+}
+
+int main() {
+	using namespace tchess;
+	bool passed = testPvWindow();
+	passed = testFullWindowMate() && passed;
+	return passed ? 0 : 1;
+}